@@ -1,11 +1,184 @@
 #ifndef PY_ALGO_H
 #define PY_ALGO_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
 #include <memory>
 #include <iterator>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+#if __cplusplus >= 202002L && __has_include(<ranges>)
+#include <ranges>
+#endif
+
+#include "py_algo_execution.h"
+#include "py_algo_instrument.h"
+#include "py_algo_simd.h"
 
 namespace py_algo {
+#if __cplusplus >= 201703L
+
+    template<typename T>
+    class xrange_iterator;
+
+    namespace detail {
+
+        template<typename Iterator>
+        struct is_xrange_iterator : std::false_type {};
+
+        template<typename T>
+        struct is_xrange_iterator<xrange_iterator<T>> : std::true_type {};
+
+        template<typename Iterator>
+        inline constexpr bool is_xrange_iterator_v = is_xrange_iterator<Iterator>::value;
+
+        // Lets algorithms read the progression behind an xrange_iterator instead of walking it
+        struct xrange_access {
+            template<typename T>
+            static constexpr auto start(const xrange_iterator<T>& _iter) noexcept {
+                return _iter.stored_start;
+            }
+
+            template<typename T>
+            static constexpr auto step(const xrange_iterator<T>& _iter) noexcept {
+                return _iter.stored_step;
+            }
+
+            template<typename T>
+            static constexpr auto index(const xrange_iterator<T>& _iter) noexcept {
+                return _iter.stored_index;
+            }
+        };
+
+        /**
+         * Element start + index * step of a progression. Integers are computed modulo 2^n, so an
+         * element that fits T never overflows on the way, and a value past T wraps.
+         */
+        template<typename T>
+        constexpr T progression_value(T _start, T _step, std::ptrdiff_t _index) noexcept {
+            if constexpr (std::is_integral_v<T>)
+                return static_cast<T>(static_cast<std::uintmax_t>(_start) +
+                                      static_cast<std::uintmax_t>(_index) * static_cast<std::uintmax_t>(_step));
+            else
+                return static_cast<T>(_start + _index * _step);
+        }
+
+        /**
+         * Index k >= 0 such that start + k * step == x, or -1 if x is not on the progression
+         */
+        template<typename T>
+        constexpr std::ptrdiff_t progression_index(T _start, T _step, T _x) noexcept {
+            if constexpr (std::is_integral_v<T>) {
+                typedef std::make_unsigned_t<T> unsigned_type;
+                unsigned_type distance;
+                unsigned_type stride;
+                if (_step > T()) {
+                    if (_x < _start)
+                        return -1;
+                    distance = static_cast<unsigned_type>(static_cast<unsigned_type>(_x) - static_cast<unsigned_type>(_start));
+                    stride = static_cast<unsigned_type>(_step);
+                } else {
+                    if (_x > _start)
+                        return -1;
+                    distance = static_cast<unsigned_type>(static_cast<unsigned_type>(_start) - static_cast<unsigned_type>(_x));
+                    stride = static_cast<unsigned_type>(unsigned_type() - static_cast<unsigned_type>(_step));
+                }
+                if (distance % stride != 0 || distance / stride > static_cast<unsigned_type>(PTRDIFF_MAX))
+                    return -1;
+
+                return static_cast<std::ptrdiff_t>(distance / stride);
+            } else {
+                auto k = (_x - _start) / _step;
+                if (!(k > -1 && k < static_cast<T>(PTRDIFF_MAX / 2)))
+                    return -1;
+                // Must reproduce the value the iterator yields, not just be close to it, and the
+                // quotient may round to a neighbour of the index that does
+                auto nearest = static_cast<std::ptrdiff_t>(k + T(0.5));
+                for (auto index: {nearest - 1, nearest, nearest + 1}) {
+                    if (index >= 0 && progression_value(_start, _step, index) == _x)
+                        return index;
+                }
+                return -1;
+            }
+        }
+
+        /**
+         * Index in [_first, _last) at which the progression yields _x, or -1 if there is none.
+         * A floating point step below the ulp of the values repeats a value at neighbouring
+         * indices; those form one run, and the last index of it in the window is returned when
+         * _backward is set, the first otherwise.
+         */
+        template<typename T>
+        constexpr std::ptrdiff_t progression_index(T _start, T _step, T _x, std::ptrdiff_t _first, std::ptrdiff_t _last,
+                                                   bool _backward = false) noexcept {
+            auto index = progression_index(_start, _step, _x);
+            if constexpr (std::is_floating_point_v<T>) {
+                if (index < 0 || _first >= _last)
+                    return -1;
+
+                auto yields = [&](std::ptrdiff_t _i) { return progression_value(_start, _step, _i) == _x; };
+                // The run holds the window end nearest to a match outside the window, if any
+                index = std::clamp(index, _first, _last - 1);
+                if (!yields(index))
+                    return -1;
+
+                // Gallop towards the requested end of the run, then bisect between the last
+                // index known to yield _x and the first one known not to
+                std::ptrdiff_t direction = _backward ? 1 : -1;
+                auto room = [&] { return _backward ? _last - 1 - index : index - _first; };
+                std::ptrdiff_t distance = 1;
+                while (distance <= room() && yields(index + direction * distance)) {
+                    index += direction * distance;
+                    if (distance <= PTRDIFF_MAX / 2)
+                        distance *= 2;
+                }
+                auto miss = index + direction * std::min(distance, room() + 1);
+                while (miss - index > 1 || index - miss > 1) {
+                    auto middle = index + (miss - index) / 2;
+                    if (yields(middle))
+                        index = middle;
+                    else
+                        miss = middle;
+                }
+
+                return index;
+            } else {
+                return index >= _first && index < _last ? index : -1;
+            }
+        }
+
+#ifdef __SIZEOF_INT128__
+        __extension__ typedef unsigned __int128 uint128_type;
+#else
+        typedef void uint128_type;
+#endif
+
+        // Unsigned type holding the product of two values of the integer type T, void if there is none
+        template<typename T>
+        using wide_unsigned_t = std::conditional_t<sizeof(T) <= sizeof(std::uint32_t), std::uint64_t, uint128_type>;
+
+    } // namespace detail
+
+#endif
+
 #if __cplusplus < 201703L
 
     template<typename InputIt, typename UnaryPredicate>
@@ -36,14 +209,49 @@ namespace py_algo {
             typename std::iterator_traits<InputIt>::iterator_category>>,
         typename UnaryPredicate>
     constexpr bool all_of(InputIt first, InputIt last, UnaryPredicate p) {
+        detail::call_probe probe("all_of", first, last);
+        auto&& test = probe.counted(p);
         for (; first != last; ++first) {
-            if (!p(*first))
+            if (!test(*first)) {
+                probe.exit_here();
                 return false;
+            }
         }
 
         return true;
     }
 
+
+    /**
+     * Checks that all elements fit the condition, splitting the range across threads
+     * for parallel policies. Workers stop as soon as any of them meets a failing element.
+     *
+     * @tparam ExecutionPolicy One of py_algo::execution policies
+     * @tparam ForwardIt Forward iterator, parallel execution needs random access
+     * @tparam UnaryPredicate Type of predicator
+     * @return bool value
+     */
+    template<
+        typename ExecutionPolicy,
+        typename ForwardIt,
+        typename UnaryPredicate,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    bool all_of(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p) {
+        if constexpr (detail::runs_parallel_v<ExecutionPolicy, ForwardIt>) {
+            detail::call_probe probe("all_of", first, last);
+            probe.use(call_kernel::parallel);
+            auto&& test = probe.counted_concurrent(p);
+            auto fails = [&test](auto&& value) { return !test(value); };
+            if (detail::parallel_any(detail::executor_of(policy), first, last, fails)) {
+                probe.exit_early();
+                return false;
+            }
+            return true;
+        } else {
+            return py_algo::all_of(first, last, p);
+        }
+    }
+
 #endif
 
 #if __cplusplus < 201703L
@@ -66,14 +274,39 @@ namespace py_algo {
             typename std::iterator_traits<InputIt>::iterator_category>>,
         typename UnaryPredicate>
     constexpr bool any_of(InputIt first, InputIt last, UnaryPredicate p) {
+        detail::call_probe probe("any_of", first, last);
+        auto&& test = probe.counted(p);
         for (; first != last; ++first) {
-            if (p(*first))
+            if (test(*first)) {
+                probe.exit_here();
                 return true;
+            }
         }
 
         return false;
     }
 
+
+    template<
+        typename ExecutionPolicy,
+        typename ForwardIt,
+        typename UnaryPredicate,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    bool any_of(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p) {
+        if constexpr (detail::runs_parallel_v<ExecutionPolicy, ForwardIt>) {
+            detail::call_probe probe("any_of", first, last);
+            probe.use(call_kernel::parallel);
+            auto&& test = probe.counted_concurrent(p);
+            if (detail::parallel_any(detail::executor_of(policy), first, last, test)) {
+                probe.exit_early();
+                return true;
+            }
+            return false;
+        } else {
+            return py_algo::any_of(first, last, p);
+        }
+    }
+
 #endif
 
 #if __cplusplus < 201703L
@@ -96,14 +329,39 @@ namespace py_algo {
             typename std::iterator_traits<InputIt>::iterator_category>>,
         typename UnaryPredicate>
     constexpr bool none_of(InputIt first, InputIt last, UnaryPredicate p) {
+        detail::call_probe probe("none_of", first, last);
+        auto&& test = probe.counted(p);
         for (; first != last; ++first) {
-            if (p(*first))
+            if (test(*first)) {
+                probe.exit_here();
                 return false;
+            }
         }
 
         return true;
     }
 
+
+    template<
+        typename ExecutionPolicy,
+        typename ForwardIt,
+        typename UnaryPredicate,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    bool none_of(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p) {
+        if constexpr (detail::runs_parallel_v<ExecutionPolicy, ForwardIt>) {
+            detail::call_probe probe("none_of", first, last);
+            probe.use(call_kernel::parallel);
+            auto&& test = probe.counted_concurrent(p);
+            if (detail::parallel_any(detail::executor_of(policy), first, last, test)) {
+                probe.exit_early();
+                return false;
+            }
+            return true;
+        } else {
+            return py_algo::none_of(first, last, p);
+        }
+    }
+
 #endif
 
 #if __cplusplus < 201703L
@@ -131,178 +389,1032 @@ namespace py_algo {
             typename std::iterator_traits<InputIt>::iterator_category>>,
         typename UnaryPredicate>
     constexpr bool one_of(InputIt first, InputIt last, UnaryPredicate p) {
+        detail::call_probe probe("one_of", first, last);
+        auto&& test = probe.counted(p);
         bool one_found = false;
         for (; first != last; ++first) {
-            if (p(*first)) {
-                if (one_found)
+            if (test(*first)) {
+                if (one_found) {
+                    probe.exit_here();
                     return false;
-                else
-                    one_found = true;
+                }
+                one_found = true;
             }
         }
 
         return one_found;
     }
 
-#endif
 
-#if __cplusplus < 201703L
+    /**
+     * Parallel one_of: all workers stop once a second match is found anywhere in the range
+     */
+    template<
+        typename ExecutionPolicy,
+        typename ForwardIt,
+        typename UnaryPredicate,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    bool one_of(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p) {
+        if constexpr (detail::runs_parallel_v<ExecutionPolicy, ForwardIt>) {
+            detail::call_probe probe("one_of", first, last);
+            probe.use(call_kernel::parallel);
+            auto&& test = probe.counted_concurrent(p);
+            auto count = detail::parallel_count_up_to(detail::executor_of(policy), first, last, test, 2);
+            if (count == 2)
+                probe.exit_early();
+            return count == 1;
+        } else {
+            return py_algo::one_of(first, last, p);
+        }
+    }
 
-    template<typename ForwardIt>
-    bool is_sorted(ForwardIt first, ForwardIt last) {
-        if (first == last)
-            return true;
+    /**
+     * Kernel of none_of(), one_of() and is_partitioned() overloads taking a mode. Branchy scans
+     * stop at the deciding element. Branchless scans add predicate results up a block at a time
+     * and only check them at block ends, which lets simple predicates vectorize but reads up to
+     * a block past the answer. Adaptive scans read the first, smaller block branchless and pick
+     * one of the two for the rest by how many elements of that sample matched.
+     */
+    enum class branch_mode {
+        branchy,
+        branchless,
+        adaptive
+    };
 
-        for (ForwardIt second = first + 1; second != last; second++, first++) {
-            if (*second < *first)
-                return false;
+    namespace detail {
+
+        // Elements a branchless scan evaluates between checks
+        inline constexpr std::ptrdiff_t branch_block = 256;
+
+        // Elements an adaptive scan samples before it picks a kernel
+        inline constexpr std::ptrdiff_t branch_sample = 64;
+
+        /**
+         * Writes the results of p for up to _limit elements from first into _hits
+         * and advances first past them
+         *
+         * @return Number of elements read
+         */
+        template<typename InputIt, typename UnaryPredicate>
+        std::ptrdiff_t evaluate_block(InputIt& first, InputIt last, std::ptrdiff_t _limit, UnaryPredicate& p,
+                                      unsigned char* _hits) {
+            if constexpr (is_random_access_v<InputIt>) {
+                auto size = std::min(_limit, static_cast<std::ptrdiff_t>(last - first));
+                for (std::ptrdiff_t i = 0; i < size; ++i)
+                    _hits[i] = static_cast<bool>(p(first[i]));
+                first += size;
+                return size;
+            } else {
+                std::ptrdiff_t size = 0;
+                for (; size < _limit && first != last; ++size, ++first)
+                    _hits[size] = static_cast<bool>(p(*first));
+                return size;
+            }
         }
 
-        return true;
-    }
+        // Matches among up to _limit elements from first, which is advanced past them
+        template<typename InputIt, typename UnaryPredicate>
+        std::size_t count_block(InputIt& first, InputIt last, std::ptrdiff_t _limit, UnaryPredicate& p) {
+            std::size_t matches = 0;
+            if constexpr (is_random_access_v<InputIt>) {
+                auto size = std::min(_limit, static_cast<std::ptrdiff_t>(last - first));
+                for (std::ptrdiff_t i = 0; i < size; ++i)
+                    matches += static_cast<bool>(p(first[i]));
+                first += size;
+            } else {
+                for (std::ptrdiff_t i = 0; i < _limit && first != last; ++i, ++first)
+                    matches += static_cast<bool>(p(*first));
+            }
 
-#else
+            return matches;
+        }
 
-    template<
-        typename ForwardIt,
-        typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
-            typename std::iterator_traits<ForwardIt>::iterator_category>>>
-    constexpr bool is_sorted(ForwardIt first, ForwardIt last) {
-        if (first == last)
-            return true;
+        /**
+         * Counts matches up to _limit, the count at which the answer is known
+         *
+         * @return min(matches, _limit), or a count of at least _limit if the scan stopped early
+         */
+        template<typename InputIt, typename UnaryPredicate, typename Probe>
+        std::size_t count_up_to(branch_mode _mode, InputIt first, InputIt last, UnaryPredicate& p,
+                                std::size_t _limit, Probe& _probe) {
+            std::size_t matches = 0;
+            if (_mode == branch_mode::adaptive) {
+                matches = count_block(first, last, branch_sample, p);
+                if (matches >= _limit) {
+                    _probe.exit_early();
+                    return matches;
+                }
+                // A sample with matches makes the deciding one likely to come soon, and the
+                // branchy kernel stops right at it instead of finishing a block
+                _mode = matches == 0 ? branch_mode::branchless : branch_mode::branchy;
+            }
 
-        for (auto second = first + 1; second != last; second++, first++) {
-            if (*second < *first)
-                return false;
-        }
+            if (_mode == branch_mode::branchy) {
+                for (; first != last; ++first) {
+                    if (p(*first) && ++matches == _limit) {
+                        _probe.exit_here();
+                        return matches;
+                    }
+                }
+                return matches;
+            }
 
-        return true;
-    }
+            while (first != last) {
+                matches += count_block(first, last, branch_block, p);
+                if (matches >= _limit) {
+                    _probe.exit_early();
+                    return matches;
+                }
+            }
 
-#endif
+            return matches;
+        }
 
-#if __cplusplus < 201703L
+        /**
+         * Branchless is_partitioned: a range is partitioned unless a match directly follows
+         * a mismatch, and such rises are summed over a block of buffered results
+         */
+        template<typename ForwardIt, typename UnaryPredicate, typename Probe>
+        bool is_partitioned_blocks(ForwardIt first, ForwardIt last, UnaryPredicate& p, std::ptrdiff_t _first_block,
+                                   Probe& _probe) {
+            unsigned char hits[branch_block + 1];
+            // Result of the element before the block, a match before the range
+            hits[0] = 1;
+            auto block = _first_block;
+            while (first != last) {
+                auto size = evaluate_block(first, last, block, p, hits + 1);
+                unsigned rises = 0;
+                for (std::ptrdiff_t i = 0; i < size; ++i)
+                    rises += hits[i] < hits[i + 1];
+                if (rises != 0) {
+                    _probe.exit_early();
+                    return false;
+                }
+                hits[0] = hits[size];
+                block = branch_block;
+            }
 
-    template<typename ForwardIt, typename Compare>
-    bool is_sorted(ForwardIt first, ForwardIt last, Compare comp) {
-        if (first == last)
             return true;
-
-        for (ForwardIt second = first + 1; second != last; second++, first++) {
-            if (comp(*second, *first))
-                return false;
         }
 
-        return true;
-    }
+    } // namespace detail
 
-#else
+    /**
+     * none_of() with the scan kernel chosen by _mode
+     */
+    template<
+        typename InputIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
+            typename std::iterator_traits<InputIt>::iterator_category>>,
+        typename UnaryPredicate>
+    bool none_of(branch_mode _mode, InputIt first, InputIt last, UnaryPredicate p) {
+        detail::call_probe probe("none_of", first, last);
+        auto&& test = probe.counted(p);
+        return detail::count_up_to(_mode, first, last, test, 1, probe) == 0;
+    }
 
+    /**
+     * one_of() with the scan kernel chosen by _mode
+     */
     template<
-        typename ForwardIt,
-        typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
-            typename std::iterator_traits<ForwardIt>::iterator_category>>,
-        typename Compare>
-    constexpr bool is_sorted(ForwardIt first, ForwardIt last, Compare comp) {
-        if (first == last)
-            return true;
+        typename InputIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
+            typename std::iterator_traits<InputIt>::iterator_category>>,
+        typename UnaryPredicate>
+    bool one_of(branch_mode _mode, InputIt first, InputIt last, UnaryPredicate p) {
+        detail::call_probe probe("one_of", first, last);
+        auto&& test = probe.counted(p);
+        return detail::count_up_to(_mode, first, last, test, 2, probe) == 1;
+    }
 
-        for (auto second = first + 1; second != last; second++, first++) {
-            if (comp(*second, *first))
-                return false;
-        }
+    /**
+     * Answers quantify() is asked for. A scan stops as soon as all requested answers are known,
+     * so the other fields of the result then only describe the scanned prefix.
+     */
+    enum class quantifier : unsigned {
+        all_of = 1u << 0,
+        any_of = 1u << 1,
+        none_of = 1u << 2,
+        one_of = 1u << 3,
+        count = 1u << 4,
+        first_match = 1u << 5,
+        last_match = 1u << 6,
+        everything = (1u << 7) - 1
+    };
 
-        return true;
+    constexpr quantifier operator|(quantifier _l, quantifier _r) noexcept {
+        return static_cast<quantifier>(static_cast<unsigned>(_l) | static_cast<unsigned>(_r));
     }
 
-#endif
+    constexpr quantifier operator&(quantifier _l, quantifier _r) noexcept {
+        return static_cast<quantifier>(static_cast<unsigned>(_l) & static_cast<unsigned>(_r));
+    }
 
-#if __cplusplus < 201703L
+    /**
+     * Result of quantify()
+     */
+    template<typename ForwardIt>
+    struct quantifier_stats {
+        // Matches in the scanned part of the range
+        std::size_t count;
+        // First and last match, or the end of the range if there is none
+        ForwardIt first_match;
+        ForwardIt last_match;
+        // Whether some scanned element does not match
+        bool any_mismatch;
+
+        constexpr bool all_of() const noexcept {
+            return !any_mismatch;
+        }
 
-    template<typename ForwardIt, typename UnaryPredicate>
-    bool is_partitioned(ForwardIt first, ForwardIt last, UnaryPredicate p) {
-        for (; first != last; first++) {
-            if (!p(*first))
-                break;
+        constexpr bool any_of() const noexcept {
+            return count != 0;
         }
-        for (; first != last; first++) {
-            if (p(*first))
+
+        constexpr bool none_of() const noexcept {
+            return count == 0;
+        }
+
+        constexpr bool one_of() const noexcept {
+            return count == 1;
+        }
+    };
+
+    namespace detail {
+
+        constexpr bool has_quantifier(quantifier _requested, quantifier _answer) noexcept {
+            return (_requested & _answer) == _answer;
+        }
+
+        // Whether the requested answers no longer depend on the elements left to scan
+        constexpr bool quantifiers_decided(quantifier _requested, std::size_t _count, bool _any_mismatch) noexcept {
+            if (has_quantifier(_requested, quantifier::count) || has_quantifier(_requested, quantifier::last_match))
+                return false;
+            if (has_quantifier(_requested, quantifier::all_of) && !_any_mismatch)
                 return false;
+            if (has_quantifier(_requested, quantifier::one_of) && _count < 2)
+                return false;
+
+            return _count != 0 || !(has_quantifier(_requested, quantifier::any_of) ||
+                                    has_quantifier(_requested, quantifier::none_of) ||
+                                    has_quantifier(_requested, quantifier::first_match));
         }
 
-        return true;
-    }
+        // Elements quantify() evaluates before it checks whether it can stop
+        inline constexpr std::ptrdiff_t quantify_block = 256;
+
+        /**
+         * Adds _size <= quantify_block elements starting at first to _stats. Predicate results
+         * go to a byte buffer first, which keeps the counting loop free of branches.
+         */
+        template<typename RandomIt, typename UnaryPredicate>
+        void quantify_block_into(RandomIt first, std::ptrdiff_t _size, UnaryPredicate& p,
+                                 quantifier_stats<RandomIt>& _stats) {
+            unsigned char hits[quantify_block];
+            std::ptrdiff_t matches = 0;
+            for (std::ptrdiff_t i = 0; i < _size; ++i) {
+                hits[i] = static_cast<bool>(p(first[i]));
+                matches += hits[i];
+            }
+            if (matches != _size)
+                _stats.any_mismatch = true;
+            if (matches == 0)
+                return;
+
+            if (_stats.count == 0) {
+                std::ptrdiff_t i = 0;
+                while (!hits[i])
+                    ++i;
+                _stats.first_match = first + i;
+            }
+            std::ptrdiff_t i = _size - 1;
+            while (!hits[i])
+                --i;
+            _stats.last_match = first + i;
+            _stats.count += static_cast<std::size_t>(matches);
+        }
 
-#else
+        template<typename RandomIt, typename UnaryPredicate>
+        quantifier_stats<RandomIt> quantify_blocks(RandomIt first, RandomIt last, UnaryPredicate& p,
+                                                   quantifier _requested) {
+            quantifier_stats<RandomIt> stats{0, last, last, false};
+            while (first != last) {
+                auto block = std::min(quantify_block, static_cast<std::ptrdiff_t>(last - first));
+                quantify_block_into(first, block, p, stats);
+                if (quantifiers_decided(_requested, stats.count, stats.any_mismatch))
+                    break;
+                first += block;
+            }
+
+            return stats;
+        }
+
+        /**
+         * Chunks merge their blocks into shared counters. A chunk stops once the answers
+         * are decided and, if the first match is requested, a match before it is known.
+         */
+        template<typename Executor, typename RandomIt, typename UnaryPredicate>
+        quantifier_stats<RandomIt> parallel_quantify(Executor& _executor, RandomIt first, RandomIt last, UnaryPredicate& p,
+                                                     quantifier _requested) {
+            auto size = last - first;
+            bool want_first = has_quantifier(_requested, quantifier::first_match);
+            auto others = static_cast<quantifier>(static_cast<unsigned>(_requested) &
+                                                  ~static_cast<unsigned>(quantifier::first_match));
+            std::atomic<std::size_t> count{0};
+            std::atomic<std::ptrdiff_t> first_match{size};
+            std::atomic<std::ptrdiff_t> last_match{-1};
+            std::atomic<bool> any_mismatch{false};
+            parallel_chunks(_executor, first, last, default_grain, [&](RandomIt chunk_first, RandomIt chunk_last) {
+                while (chunk_first != chunk_last) {
+                    if (quantifiers_decided(others, count.load(std::memory_order_relaxed),
+                                            any_mismatch.load(std::memory_order_relaxed)) &&
+                        (!want_first || first_match.load(std::memory_order_relaxed) < chunk_first - first))
+                        return;
+
+                    auto block = std::min(quantify_block, static_cast<std::ptrdiff_t>(chunk_last - chunk_first));
+                    quantifier_stats<RandomIt> local{0, last, last, false};
+                    quantify_block_into(chunk_first, block, p, local);
+                    if (local.count != 0) {
+                        count.fetch_add(local.count, std::memory_order_relaxed);
+                        atomic_min(first_match, local.first_match - first);
+                        atomic_max(last_match, local.last_match - first);
+                    }
+                    if (local.any_mismatch)
+                        any_mismatch.store(true, std::memory_order_relaxed);
+                    chunk_first += block;
+                }
+            });
+
+            auto found = last_match.load() >= 0;
+            return {count.load(), found ? first + first_match.load() : last, found ? first + last_match.load() : last,
+                    any_mismatch.load()};
+        }
+
+    } // namespace detail
 
+    /**
+     * Evaluates all_of, any_of, none_of and one_of in a single pass with one predicate call per element
+     *
+     * @tparam ForwardIt Forward iterator
+     * @tparam UnaryPredicate Type of predicate
+     * @param requested Answers the caller needs; the scan stops once they are decided
+     * @return quantifier_stats with the match count, the first and last match and the derived answers
+     */
     template<
         typename ForwardIt,
         typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
             typename std::iterator_traits<ForwardIt>::iterator_category>>,
         typename UnaryPredicate>
-    constexpr bool is_partitioned(ForwardIt first, ForwardIt last, UnaryPredicate p) {
-        for (; first != last; first++) {
-            if (!p(*first))
-                break;
+    constexpr quantifier_stats<ForwardIt> quantify(ForwardIt first, ForwardIt last, UnaryPredicate p,
+                                                   quantifier requested = quantifier::everything) {
+#ifdef __cpp_lib_is_constant_evaluated
+        if constexpr (detail::is_random_access_v<ForwardIt>) {
+            if (!std::is_constant_evaluated())
+                return detail::quantify_blocks(first, last, p, requested);
         }
-        for (; first != last; first++) {
-            if (p(*first))
-                return false;
+#endif
+        quantifier_stats<ForwardIt> stats{0, last, last, false};
+        for (; first != last; ++first) {
+            if (p(*first)) {
+                if (stats.count++ == 0)
+                    stats.first_match = first;
+                stats.last_match = first;
+                if (stats.count <= 2 && detail::quantifiers_decided(requested, stats.count, stats.any_mismatch))
+                    break;
+            } else if (!stats.any_mismatch) {
+                stats.any_mismatch = true;
+                if (detail::quantifiers_decided(requested, stats.count, stats.any_mismatch))
+                    break;
+            }
         }
 
-        return true;
+        return stats;
+    }
+
+    template<
+        typename ExecutionPolicy,
+        typename ForwardIt,
+        typename UnaryPredicate,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    quantifier_stats<ForwardIt> quantify(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p,
+                                         quantifier requested = quantifier::everything) {
+        if constexpr (detail::runs_parallel_v<ExecutionPolicy, ForwardIt>)
+            return detail::parallel_quantify(detail::executor_of(policy), first, last, p, requested);
+        else
+            return py_algo::quantify(first, last, p, requested);
     }
 
 #endif
 
 #if __cplusplus < 201703L
 
-    template<typename InputIt, typename T>
-    InputIt find_not(InputIt first, InputIt last, const T& x) {
-        for (; first != last; first++) {
-            if (*first != x)
-                return first;
+    template<typename ForwardIt, typename Compare>
+    ForwardIt is_sorted_until(ForwardIt first, ForwardIt last, Compare comp) {
+        if (first == last)
+            return last;
+
+        for (ForwardIt second = std::next(first); second != last; ++second, ++first) {
+            if (comp(*second, *first))
+                return second;
         }
 
-        return first;
+        return last;
     }
 
-#else
-
-    template<
-        typename InputIt,
-        typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
-            typename std::iterator_traits<InputIt>::iterator_category>>,
-        typename T>
-    constexpr InputIt find_not(InputIt first, InputIt last, const T& x) {
-        for (; first != last; first++) {
-            if (*first != x)
-                return first;
-        }
+    template<typename ForwardIt>
+    ForwardIt is_sorted_until(ForwardIt first, ForwardIt last) {
+        return py_algo::is_sorted_until(first, last, std::less<typename std::iterator_traits<ForwardIt>::value_type>());
+    }
 
-        return first;
+    template<typename ForwardIt>
+    bool is_sorted(ForwardIt first, ForwardIt last) {
+        return py_algo::is_sorted_until(first, last) == last;
     }
 
-#endif
+    template<typename ForwardIt, typename Compare>
+    bool is_sorted(ForwardIt first, ForwardIt last, Compare comp) {
+        return py_algo::is_sorted_until(first, last, comp) == last;
+    }
 
-#if __cplusplus < 201703L
+#else
 
-    template<typename BiDirIt, typename T>
-    BiDirIt find_backward(BiDirIt first, BiDirIt last, const T& x) {
-        while (last-- != first) {
-            if (*last == x)
-                return last;
-        }
+    namespace detail {
 
-        return last;
-    }
+        // Comparators that mean operator<, for which the vector kernels are valid
+        template<typename Compare, typename T>
+        inline constexpr bool is_default_less_v = std::is_same_v<Compare, std::less<>> ||
+                                                  std::is_same_v<Compare, std::less<T>>;
 
-#else
+    } // namespace detail
 
     /**
-     * Finds first element from end that is equal to some value
+     * Finds the first element that is out of order relative to its predecessor
      *
-     * @tparam InputIt Bidirectional iterator
+     * @tparam ForwardIt Forward iterator
+     * @tparam Compare Type of comparator
+     * @param first first input iterator
+     * @param last second input iterator
+     * @param comp comparator
+     * @return Iterator to the first element e with comp(e, predecessor), or last
+     */
+    template<
+        typename ForwardIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<ForwardIt>::iterator_category>>,
+        typename Compare>
+    constexpr ForwardIt is_sorted_until(ForwardIt first, ForwardIt last, Compare comp) {
+        typedef typename std::iterator_traits<ForwardIt>::value_type value_type;
+        if constexpr (detail::is_xrange_iterator_v<ForwardIt> && detail::is_default_less_v<Compare, value_type>) {
+            if (last - first <= 1 || detail::xrange_access::step(first) > 0)
+                return last;
+            if constexpr (std::is_integral_v<value_type>)
+                return first + 1;
+        }
+#ifdef PY_ALGO_SIMD_DISPATCH
+        if constexpr (detail::is_default_less_v<Compare, value_type> &&
+                      detail::simd::is_dispatchable_v<ForwardIt, value_type>) {
+            if (!std::is_constant_evaluated()) {
+                auto base = std::to_address(first);
+                return first + (detail::simd::is_sorted_until(base, base + (last - first)) - base);
+            }
+        }
+#endif
+        if (first == last)
+            return last;
+
+        for (auto second = std::next(first); second != last; ++second, ++first) {
+            if (comp(*second, *first))
+                return second;
+        }
+
+        return last;
+    }
+
+    template<
+        typename ForwardIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<ForwardIt>::iterator_category>>>
+    constexpr ForwardIt is_sorted_until(ForwardIt first, ForwardIt last) {
+        return py_algo::is_sorted_until(first, last, std::less<>());
+    }
+
+    template<
+        typename ForwardIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<ForwardIt>::iterator_category>>>
+    constexpr bool is_sorted(ForwardIt first, ForwardIt last) {
+        return py_algo::is_sorted_until(first, last) == last;
+    }
+
+    template<
+        typename ForwardIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<ForwardIt>::iterator_category>>,
+        typename Compare>
+    constexpr bool is_sorted(ForwardIt first, ForwardIt last, Compare comp) {
+        return py_algo::is_sorted_until(first, last, comp) == last;
+    }
+
+    /**
+     * Result of sortedness(): how far a range is from being sorted
+     */
+    template<typename ForwardIt>
+    struct sortedness_stats {
+        // First element that is out of order, as is_sorted_until returns it
+        ForwardIt first_violation;
+        // Adjacent pairs whose second element goes before the first one
+        std::size_t descents;
+        // Maximal sorted runs the range splits into, zero for an empty range
+        std::size_t runs;
+
+        constexpr bool sorted() const noexcept {
+            return descents == 0;
+        }
+    };
+
+    /**
+     * Measures sortedness of a range in one pass
+     *
+     * @tparam ForwardIt Forward iterator
+     * @tparam Compare Type of comparator
+     * @return sortedness_stats with the first violation, descent and run counts
+     */
+    template<
+        typename ForwardIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<ForwardIt>::iterator_category>>,
+        typename Compare = std::less<>>
+    constexpr sortedness_stats<ForwardIt> sortedness(ForwardIt first, ForwardIt last, Compare comp = Compare()) {
+        sortedness_stats<ForwardIt> stats{last, 0, 0};
+        if (first == last)
+            return stats;
+
+        stats.first_violation = py_algo::is_sorted_until(first, last, comp);
+        if (stats.first_violation != last) {
+            typedef typename std::iterator_traits<ForwardIt>::value_type value_type;
+#ifdef PY_ALGO_SIMD_DISPATCH
+            if constexpr (detail::is_default_less_v<Compare, value_type> &&
+                          detail::simd::is_dispatchable_v<ForwardIt, value_type>) {
+                if (!std::is_constant_evaluated()) {
+                    auto base = std::to_address(stats.first_violation);
+                    stats.descents = detail::simd::count_descents(base - 1, base + (last - stats.first_violation));
+                    stats.runs = stats.descents + 1;
+                    return stats;
+                }
+            }
+#endif
+            auto previous = stats.first_violation;
+            stats.descents = 1;
+            for (auto current = std::next(previous); current != last; ++current, ++previous)
+                stats.descents += comp(*current, *previous) ? 1 : 0;
+        }
+        stats.runs = stats.descents + 1;
+
+        return stats;
+    }
+
+    namespace detail {
+
+        // Chunks split the adjacent pairs, so each chunk reads one element past its end to check the boundary
+        template<typename Executor, typename RandomIt, typename Compare>
+        RandomIt parallel_is_sorted_until(Executor& _executor, RandomIt first, RandomIt last, Compare& comp) {
+            auto size = last - first;
+            if (size < 2)
+                return last;
+
+            std::atomic<std::ptrdiff_t> violation{size};
+            parallel_chunks(_executor, first, last - 1, default_grain, [&](RandomIt chunk_first, RandomIt chunk_last) {
+                while (chunk_first != chunk_last && chunk_first - first < violation.load(std::memory_order_relaxed)) {
+                    auto block_last = chunk_first + std::min<std::ptrdiff_t>(cancel_block, chunk_last - chunk_first);
+                    auto found = py_algo::is_sorted_until(chunk_first, block_last + 1, comp);
+                    if (found != block_last + 1) {
+                        atomic_min(violation, found - first);
+                        return;
+                    }
+                    chunk_first = block_last;
+                }
+            });
+
+            return first + violation.load();
+        }
+
+        template<typename Executor, typename RandomIt, typename Compare>
+        sortedness_stats<RandomIt> parallel_sortedness(Executor& _executor, RandomIt first, RandomIt last, Compare& comp) {
+            auto size = last - first;
+            if (size < 2)
+                return {last, 0, size == 0 ? std::size_t(0) : std::size_t(1)};
+
+            std::atomic<std::ptrdiff_t> violation{size};
+            std::atomic<std::size_t> descents{0};
+            parallel_chunks(_executor, first, last - 1, default_grain, [&](RandomIt chunk_first, RandomIt chunk_last) {
+                auto stats = py_algo::sortedness(chunk_first, chunk_last + 1, comp);
+                if (!stats.sorted()) {
+                    descents.fetch_add(stats.descents, std::memory_order_relaxed);
+                    atomic_min(violation, stats.first_violation - first);
+                }
+            });
+
+            return {first + violation.load(), descents.load(), descents.load() + 1};
+        }
+
+    } // namespace detail
+
+    /**
+     * Parallel is_sorted_until: chunks of the range are checked concurrently, each one
+     * including the pair across its end, and chunks past a found violation stop early
+     */
+    template<
+        typename ExecutionPolicy,
+        typename ForwardIt,
+        typename Compare = std::less<>,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    ForwardIt is_sorted_until(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp = Compare()) {
+        if constexpr (detail::runs_parallel_v<ExecutionPolicy, ForwardIt>)
+            return detail::parallel_is_sorted_until(detail::executor_of(policy), first, last, comp);
+        else
+            return py_algo::is_sorted_until(first, last, comp);
+    }
+
+    template<
+        typename ExecutionPolicy,
+        typename ForwardIt,
+        typename Compare = std::less<>,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    bool is_sorted(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp = Compare()) {
+        return py_algo::is_sorted_until(std::forward<ExecutionPolicy>(policy), first, last, comp) == last;
+    }
+
+    template<
+        typename ExecutionPolicy,
+        typename ForwardIt,
+        typename Compare = std::less<>,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    sortedness_stats<ForwardIt> sortedness(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, Compare comp = Compare()) {
+        if constexpr (detail::runs_parallel_v<ExecutionPolicy, ForwardIt>)
+            return detail::parallel_sortedness(detail::executor_of(policy), first, last, comp);
+        else
+            return py_algo::sortedness(first, last, comp);
+    }
+
+#endif
+
+#if __cplusplus < 201703L
+
+    template<typename ForwardIt, typename UnaryPredicate>
+    bool is_partitioned(ForwardIt first, ForwardIt last, UnaryPredicate p) {
+        for (; first != last; first++) {
+            if (!p(*first))
+                break;
+        }
+        for (; first != last; first++) {
+            if (p(*first))
+                return false;
+        }
+
+        return true;
+    }
+
+#else
+
+    template<
+        typename ForwardIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<ForwardIt>::iterator_category>>,
+        typename UnaryPredicate>
+    constexpr bool is_partitioned(ForwardIt first, ForwardIt last, UnaryPredicate p) {
+        for (; first != last; first++) {
+            if (!p(*first))
+                break;
+        }
+        for (; first != last; first++) {
+            if (p(*first))
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * is_partitioned() with the scan kernel chosen by _mode. A sample that did not fail holds
+     * no match after a mismatch, so it never argues for the branchy kernel, and the adaptive
+     * mode runs branchless blocks after a smaller first one.
+     */
+    template<
+        typename ForwardIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<ForwardIt>::iterator_category>>,
+        typename UnaryPredicate>
+    bool is_partitioned(branch_mode _mode, ForwardIt first, ForwardIt last, UnaryPredicate p) {
+        detail::call_probe probe("is_partitioned", first, last);
+        auto&& test = probe.counted(p);
+        if (_mode == branch_mode::branchy) {
+            for (; first != last && test(*first); first++) {}
+            for (; first != last; first++) {
+                if (test(*first)) {
+                    probe.exit_here();
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        auto first_block = _mode == branch_mode::adaptive ? detail::branch_sample : detail::branch_block;
+        return detail::is_partitioned_blocks(first, last, test, first_block, probe);
+    }
+
+    /**
+     * Result of is_partitioned_at()
+     */
+    template<typename ForwardIt>
+    struct partition_check {
+        bool partitioned;
+        // First element that does not satisfy the predicate, i.e. the end of the leading run of matches
+        ForwardIt partition_point;
+
+        constexpr explicit operator bool() const noexcept {
+            return partitioned;
+        }
+    };
+
+    /**
+     * Tag for is_partitioned_at() on ranges already known to be partitioned:
+     * the point is found by binary search and the range is not verified
+     */
+    struct assume_partitioned_t {
+        explicit assume_partitioned_t() = default;
+    };
+
+    inline constexpr assume_partitioned_t assume_partitioned{};
+
+    /**
+     * Checks whether a range is partitioned and finds its partition point in one pass
+     *
+     * @tparam ForwardIt Forward iterator
+     * @tparam UnaryPredicate Type of predicate
+     * @return partition_check with the result and the end of the leading run of matches
+     */
+    template<
+        typename ForwardIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<ForwardIt>::iterator_category>>,
+        typename UnaryPredicate>
+    constexpr partition_check<ForwardIt> is_partitioned_at(ForwardIt first, ForwardIt last, UnaryPredicate p) {
+        for (; first != last && p(*first); first++) {}
+
+        auto point = first;
+        for (; first != last; first++) {
+            if (p(*first))
+                return {false, point};
+        }
+
+        return {true, point};
+    }
+
+    /**
+     * Finds the partition point of a range known to be partitioned in O(log n) predicate calls
+     */
+    template<
+        typename ForwardIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<ForwardIt>::iterator_category>>,
+        typename UnaryPredicate>
+    constexpr partition_check<ForwardIt> is_partitioned_at(assume_partitioned_t, ForwardIt first, ForwardIt last,
+                                                           UnaryPredicate p) {
+        auto count = std::distance(first, last);
+        while (count > 0) {
+            auto half = count / 2;
+            auto middle = std::next(first, half);
+            if (p(*middle)) {
+                first = ++middle;
+                count -= half + 1;
+            } else {
+                count = half;
+            }
+        }
+
+        return {true, first};
+    }
+
+    namespace detail {
+
+        // Offset of the first element in [first, first + _limit) not satisfying p, or _limit if there is none
+        template<typename Executor, typename RandomIt, typename UnaryPredicate>
+        std::ptrdiff_t parallel_find_if_not(Executor& _executor, RandomIt first, std::ptrdiff_t _limit, UnaryPredicate& p) {
+            std::atomic<std::ptrdiff_t> found{_limit};
+            parallel_chunks(_executor, first, first + _limit, default_grain, [&](RandomIt chunk_first, RandomIt chunk_last) {
+                for (; chunk_first != chunk_last && chunk_first - first < found.load(std::memory_order_relaxed); ++chunk_first) {
+                    if (!p(*chunk_first)) {
+                        atomic_min(found, chunk_first - first);
+                        return;
+                    }
+                }
+            });
+
+            return found.load();
+        }
+
+        /**
+         * Every chunk is all-true, all-false or true-then-false (anything else fails at once).
+         * The range is partitioned if the last match of all chunks precedes the first mismatch.
+         */
+        template<typename Executor, typename RandomIt, typename UnaryPredicate>
+        partition_check<RandomIt> parallel_is_partitioned_at(Executor& _executor, RandomIt first, RandomIt last, UnaryPredicate& p) {
+            auto size = last - first;
+            std::atomic<std::ptrdiff_t> first_false{size};
+            std::atomic<std::ptrdiff_t> last_true{-1};
+            cancellation_token broken;
+            parallel_chunks(_executor, first, last, default_grain, broken, [&](RandomIt chunk_first, RandomIt chunk_last) {
+                auto chunk_begin = chunk_first - first;
+                auto chunk_false = chunk_last - first;
+                while (chunk_first != chunk_last && !broken.cancelled()) {
+                    auto block_last = chunk_first + std::min<std::ptrdiff_t>(cancel_block, chunk_last - chunk_first);
+                    for (; chunk_first != block_last; ++chunk_first) {
+                        auto index = chunk_first - first;
+                        if (!p(*chunk_first)) {
+                            if (chunk_false == chunk_last - first) {
+                                chunk_false = index;
+                                atomic_min(first_false, index);
+                            }
+                        } else if (chunk_false != chunk_last - first || index > first_false.load(std::memory_order_relaxed)) {
+                            broken.cancel();
+                            return;
+                        }
+                    }
+                }
+                if (chunk_false != chunk_begin)
+                    atomic_max(last_true, chunk_false - 1);
+            });
+
+            if (!broken.cancelled() && last_true.load() < first_false.load())
+                return {true, first + first_false.load()};
+            // Chunks cancelled early may not have reported their first mismatch yet
+            return {false, first + parallel_find_if_not(_executor, first, first_false.load(), p)};
+        }
+
+    } // namespace detail
+
+    /**
+     * Parallel is_partitioned_at: chunks are classified concurrently and combined
+     * through the first mismatch and the last match they saw
+     */
+    template<
+        typename ExecutionPolicy,
+        typename ForwardIt,
+        typename UnaryPredicate,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    partition_check<ForwardIt> is_partitioned_at(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p) {
+        if constexpr (detail::runs_parallel_v<ExecutionPolicy, ForwardIt>)
+            return detail::parallel_is_partitioned_at(detail::executor_of(policy), first, last, p);
+        else
+            return py_algo::is_partitioned_at(first, last, p);
+    }
+
+    template<
+        typename ExecutionPolicy,
+        typename ForwardIt,
+        typename UnaryPredicate,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    bool is_partitioned(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, UnaryPredicate p) {
+        return py_algo::is_partitioned_at(std::forward<ExecutionPolicy>(policy), first, last, p).partitioned;
+    }
+
+#endif
+
+#if __cplusplus < 201703L
+
+    template<typename InputIt, typename T>
+    InputIt find_not(InputIt first, InputIt last, const T& x) {
+        for (; first != last; first++) {
+            if (*first != x)
+                return first;
+        }
+
+        return first;
+    }
+
+#else
+
+    namespace detail {
+
+        // find_not reporting to _probe, so internal callers can pass a null_probe and stay unrecorded
+        template<typename InputIt, typename T, typename Probe>
+        constexpr InputIt find_not(InputIt first, InputIt last, const T& x, Probe& _probe) {
+#ifdef PY_ALGO_SIMD_DISPATCH
+            if constexpr (simd::is_needle_dispatchable_v<InputIt, T>) {
+                if (!std::is_constant_evaluated()) {
+                    typename std::iterator_traits<InputIt>::value_type needle;
+                    // Every element differs from a value the element type cannot hold
+                    if (!simd::narrow_needle(x, needle)) {
+                        if (first != last) {
+                            _probe.visit();
+                            _probe.exit_at(0);
+                        }
+                        return first;
+                    }
+                    _probe.use(call_kernel::simd);
+                    auto base = std::to_address(first);
+                    auto offset = simd::find_not(base, base + (last - first), needle) - base;
+                    if (offset != last - first) {
+                        _probe.visit(static_cast<std::size_t>(offset) + 1);
+                        _probe.exit_at(offset);
+                    } else {
+                        _probe.visit(static_cast<std::size_t>(offset));
+                    }
+                    return first + offset;
+                }
+            }
+#endif
+            for (; first != last; first++) {
+                _probe.visit();
+                if (*first != x) {
+                    _probe.exit_here();
+                    return first;
+                }
+            }
+
+            return first;
+        }
+
+    } // namespace detail
+
+    template<
+        typename InputIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
+            typename std::iterator_traits<InputIt>::iterator_category>>,
+        typename T>
+    constexpr InputIt find_not(InputIt first, InputIt last, const T& x) {
+        detail::call_probe probe("find_not", first, last);
+        return detail::find_not(first, last, x, probe);
+    }
+
+    namespace detail {
+
+        // Offset of the first element in [first, first + _limit) different from x, or _limit if there is none
+        template<typename Executor, typename RandomIt, typename T, typename Probe>
+        std::ptrdiff_t parallel_find_not(Executor& _executor, RandomIt first, std::ptrdiff_t _limit, const T& x,
+                                         Probe& _probe) {
+            std::atomic<std::ptrdiff_t> found{_limit};
+            parallel_chunks(_executor, first, first + _limit, default_grain, [&](RandomIt chunk_first, RandomIt chunk_last) {
+                null_probe quiet;
+                while (chunk_first != chunk_last && chunk_first - first < found.load(std::memory_order_relaxed)) {
+                    auto block_last = chunk_first + std::min<std::ptrdiff_t>(cancel_block, chunk_last - chunk_first);
+                    auto mismatch = detail::find_not(chunk_first, block_last, x, quiet);
+                    _probe.visit_concurrent(static_cast<std::size_t>(mismatch - chunk_first) + (mismatch != block_last));
+                    if (mismatch != block_last) {
+                        atomic_min(found, mismatch - first);
+                        return;
+                    }
+                    chunk_first = block_last;
+                }
+            });
+
+            return found.load();
+        }
+
+    } // namespace detail
+
+    /**
+     * Parallel find_not: chunks are scanned concurrently in SIMD blocks, and once a
+     * mismatch is found every chunk that starts after it stops at its next block
+     */
+    template<
+        typename ExecutionPolicy,
+        typename ForwardIt,
+        typename T,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    ForwardIt find_not(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, const T& x) {
+        if constexpr (detail::runs_parallel_v<ExecutionPolicy, ForwardIt>) {
+            detail::call_probe probe("find_not", first, last);
+            probe.use(call_kernel::parallel);
+            auto offset = detail::parallel_find_not(detail::executor_of(policy), first, last - first, x, probe);
+            if (offset != last - first)
+                probe.exit_at(offset);
+            return first + offset;
+        } else {
+            return py_algo::find_not(first, last, x);
+        }
+    }
+
+#endif
+
+#if __cplusplus < 201703L
+
+    template<typename BiDirIt, typename T>
+    BiDirIt find_backward(BiDirIt first, BiDirIt last, const T& x) {
+        while (last-- != first) {
+            if (*last == x)
+                return last;
+        }
+
+        return last;
+    }
+
+#else
+
+    /**
+     * Finds first element from end that is equal to some value
+     *
+     * @tparam InputIt Bidirectional iterator
      * @tparam T Type of comparable variable
      * @param first first input iterator
      * @param last second input iterator
@@ -315,496 +1427,1959 @@ namespace py_algo {
             typename std::iterator_traits<BiDirIt>::iterator_category>>,
         typename T>
     constexpr BiDirIt find_backward(BiDirIt first, BiDirIt last, const T& x) {
-        auto saved_last = last;
-        while (last-- != first) {
-            if (*last == x)
-                return last;
-        }
+        detail::call_probe probe("find_backward", first, last);
+        if constexpr (detail::is_xrange_iterator_v<BiDirIt> &&
+                      std::is_same_v<typename std::iterator_traits<BiDirIt>::value_type, T>) {
+            auto first_index = detail::xrange_access::index(first);
+            auto index = detail::progression_index(detail::xrange_access::start(first),
+                                                   detail::xrange_access::step(first), x, first_index,
+                                                   detail::xrange_access::index(last), true);
+            if (index >= 0) {
+                probe.exit_at(index - first_index);
+                return first + (index - first_index);
+            }
+
+            return last;
+        }
+#ifdef PY_ALGO_SIMD_DISPATCH
+        if constexpr (detail::simd::is_needle_dispatchable_v<BiDirIt, T>) {
+            if (!std::is_constant_evaluated()) {
+                typename std::iterator_traits<BiDirIt>::value_type needle;
+                // No element equals a value the element type cannot hold
+                if (!detail::simd::narrow_needle(x, needle))
+                    return last;
+                probe.use(call_kernel::simd);
+                auto base = std::to_address(first);
+                auto offset = detail::simd::find_backward(base, base + (last - first), needle) - base;
+                if (offset != last - first) {
+                    probe.visit(static_cast<std::size_t>(last - first - offset));
+                    probe.exit_at(offset);
+                } else {
+                    probe.visit(static_cast<std::size_t>(offset));
+                }
+                return first + offset;
+            }
+        }
+#endif
+        auto saved_last = last;
+        while (last-- != first) {
+            probe.visit();
+            if (*last == x) {
+                if constexpr (detail::is_random_access_v<BiDirIt>)
+                    probe.exit_at(last - first);
+                else
+                    probe.exit_early();
+                return last;
+            }
+        }
 
         return saved_last;
     }
 
-#endif
+    namespace detail {
+
+        template<typename ForwardIt, typename T>
+        constexpr bool contains_needle(ForwardIt s_first, ForwardIt s_last, const T& x) {
+            for (; s_first != s_last; ++s_first) {
+                if (*s_first == x)
+                    return true;
+            }
+
+            return false;
+        }
+
+        // Scalar searches for more than simd::small_needle_set such needles go through a simd::needle_lookup
+        template<typename T, typename Needle>
+        inline constexpr bool has_needle_lookup_v = simd::is_vectorizable_v<std::remove_cv_t<T>> &&
+                                                    simd::is_narrowable_needle_v<std::remove_cv_t<T>, std::remove_cv_t<Needle>>;
+
+    } // namespace detail
+
+    /**
+     * Finds first element that is equal to none of the needles
+     *
+     * @tparam InputIt Input iterator
+     * @tparam ForwardIt Forward iterator over the needles
+     * @param s_first first needle
+     * @param s_last end of the needles
+     * @return Iterator
+     */
+    template<
+        typename InputIt,
+        typename ForwardIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
+            typename std::iterator_traits<InputIt>::iterator_category> &&
+                                    std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<ForwardIt>::iterator_category>>>
+    constexpr InputIt find_not_any_of(InputIt first, InputIt last, ForwardIt s_first, ForwardIt s_last) {
+#ifdef __cpp_lib_is_constant_evaluated
+        typedef std::remove_cv_t<typename std::iterator_traits<InputIt>::value_type> value_type;
+        typedef typename std::iterator_traits<ForwardIt>::value_type needle_type;
+#endif
+#ifdef PY_ALGO_SIMD_DISPATCH
+        if constexpr (detail::simd::is_needle_dispatchable_v<InputIt, needle_type>) {
+            if (!std::is_constant_evaluated()) {
+                auto base = std::to_address(first);
+                return first + (detail::simd::with_narrowed_needles<value_type>(s_first, s_last, [&](auto _needles, std::size_t _count) {
+                    return detail::simd::find_not_any_of(base, base + (last - first), _needles, _count);
+                }) - base);
+            }
+        }
+#endif
+#ifdef __cpp_lib_is_constant_evaluated
+        if constexpr (detail::has_needle_lookup_v<value_type, needle_type>) {
+            if (!std::is_constant_evaluated() &&
+                std::distance(s_first, s_last) > static_cast<std::ptrdiff_t>(detail::simd::small_needle_set)) {
+                auto lookup = detail::simd::with_narrowed_needles<value_type>(s_first, s_last, [](auto _needles, std::size_t _count) {
+                    return detail::simd::needle_lookup<value_type>(_needles, _count);
+                });
+                for (; first != last; first++) {
+                    if (!lookup.matches(*first))
+                        return first;
+                }
+
+                return first;
+            }
+        }
+#endif
+        for (; first != last; first++) {
+            if (!detail::contains_needle(s_first, s_last, *first))
+                return first;
+        }
+
+        return first;
+    }
+
+    template<
+        typename InputIt,
+        typename T,
+        typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
+            typename std::iterator_traits<InputIt>::iterator_category>>>
+    constexpr InputIt find_not_any_of(InputIt first, InputIt last, std::initializer_list<T> needles) {
+        return py_algo::find_not_any_of(first, last, needles.begin(), needles.end());
+    }
+
+    /**
+     * Finds first element from end that is equal to one of the needles
+     *
+     * @tparam BiDirIt Bidirectional iterator
+     * @tparam ForwardIt Forward iterator over the needles
+     * @param s_first first needle
+     * @param s_last end of the needles
+     * @return Iterator, last if there is no such element
+     */
+    template<
+        typename BiDirIt,
+        typename ForwardIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::bidirectional_iterator_tag,
+            typename std::iterator_traits<BiDirIt>::iterator_category> &&
+                                    std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<ForwardIt>::iterator_category>>>
+    constexpr BiDirIt find_backward_any_of(BiDirIt first, BiDirIt last, ForwardIt s_first, ForwardIt s_last) {
+#ifdef __cpp_lib_is_constant_evaluated
+        typedef std::remove_cv_t<typename std::iterator_traits<BiDirIt>::value_type> value_type;
+        typedef typename std::iterator_traits<ForwardIt>::value_type needle_type;
+#endif
+#ifdef PY_ALGO_SIMD_DISPATCH
+        if constexpr (detail::simd::is_needle_dispatchable_v<BiDirIt, needle_type>) {
+            if (!std::is_constant_evaluated()) {
+                auto base = std::to_address(first);
+                return first + (detail::simd::with_narrowed_needles<value_type>(s_first, s_last, [&](auto _needles, std::size_t _count) {
+                    return detail::simd::find_backward_any_of(base, base + (last - first), _needles, _count);
+                }) - base);
+            }
+        }
+#endif
+        auto saved_last = last;
+#ifdef __cpp_lib_is_constant_evaluated
+        if constexpr (detail::has_needle_lookup_v<value_type, needle_type>) {
+            if (!std::is_constant_evaluated() &&
+                std::distance(s_first, s_last) > static_cast<std::ptrdiff_t>(detail::simd::small_needle_set)) {
+                auto lookup = detail::simd::with_narrowed_needles<value_type>(s_first, s_last, [](auto _needles, std::size_t _count) {
+                    return detail::simd::needle_lookup<value_type>(_needles, _count);
+                });
+                while (last-- != first) {
+                    if (lookup.matches(*last))
+                        return last;
+                }
+
+                return saved_last;
+            }
+        }
+#endif
+        while (last-- != first) {
+            if (detail::contains_needle(s_first, s_last, *last))
+                return last;
+        }
+
+        return saved_last;
+    }
+
+    template<
+        typename BiDirIt,
+        typename T,
+        typename = std::enable_if_t<std::is_base_of_v<std::bidirectional_iterator_tag,
+            typename std::iterator_traits<BiDirIt>::iterator_category>>>
+    constexpr BiDirIt find_backward_any_of(BiDirIt first, BiDirIt last, std::initializer_list<T> needles) {
+        return py_algo::find_backward_any_of(first, last, needles.begin(), needles.end());
+    }
+
+#endif
+
+#if __cplusplus < 201703L
+
+    template<typename BiDirIt>
+    bool is_palindrome(BiDirIt first, BiDirIt last) {
+        while (first != last && first != --last) {
+            if (*first != *last)
+                return false;
+            first++;
+        }
+
+        return true;
+    }
+
+#else
+
+    template<
+        typename BiDirIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::bidirectional_iterator_tag,
+            typename std::iterator_traits<BiDirIt>::iterator_category>>>
+    constexpr bool is_palindrome(BiDirIt first, BiDirIt last) {
+        typedef typename std::iterator_traits<BiDirIt>::value_type value_type;
+        if constexpr (detail::is_xrange_iterator_v<BiDirIt> && std::is_integral_v<value_type>)
+            return last - first <= 1;
+
+#ifdef PY_ALGO_SIMD_DISPATCH
+        if constexpr (detail::simd::is_dispatchable_v<BiDirIt, value_type>) {
+            if (!std::is_constant_evaluated()) {
+                auto base = std::to_address(first);
+                auto size = static_cast<std::size_t>(last - first);
+                return detail::simd::mirrored_equal(base, base + size, size / 2);
+            }
+        }
+#endif
+        while (first != last && first != --last) {
+            if (*first != *last)
+                return false;
+            first++;
+        }
+
+        return true;
+    }
+
+    constexpr bool is_palindrome(std::string_view _str) noexcept {
+        return py_algo::is_palindrome(_str.begin(), _str.end());
+    }
+
+#ifdef __cpp_lib_span
+    template<typename T, std::size_t Extent>
+    constexpr bool is_palindrome(std::span<T, Extent> _span) {
+        return py_algo::is_palindrome(_span.begin(), _span.end());
+    }
+#endif
+
+    namespace detail {
+
+        // True if front[i] == *(back_last - 1 - i) for every i < count
+        template<typename RandomIt>
+        bool mirrored_equal(RandomIt front, RandomIt back_last, std::ptrdiff_t count) {
+#ifdef PY_ALGO_SIMD_DISPATCH
+            typedef typename std::iterator_traits<RandomIt>::value_type value_type;
+            if constexpr (simd::is_dispatchable_v<RandomIt, value_type>)
+                return simd::mirrored_equal(std::to_address(front), std::to_address(back_last),
+                                            static_cast<std::size_t>(count));
+#endif
+            for (std::ptrdiff_t i = 0; i < count; ++i) {
+                if (front[i] != back_last[-1 - i])
+                    return false;
+            }
+
+            return true;
+        }
+
+        template<typename Executor, typename RandomIt>
+        bool parallel_is_palindrome(Executor& _executor, RandomIt first, RandomIt last) {
+            auto half = (last - first) / 2;
+            cancellation_token mismatch;
+            parallel_chunks(_executor, first, first + half, default_grain, mismatch, [&](RandomIt chunk_first, RandomIt chunk_last) {
+                // The chunk [chunk_first, chunk_last) mirrors the chunk ending at back_last
+                auto back_last = last - (chunk_first - first);
+                while (chunk_first != chunk_last && !mismatch.cancelled()) {
+                    auto block = std::min<std::ptrdiff_t>(cancel_block, chunk_last - chunk_first);
+                    if (!detail::mirrored_equal(chunk_first, back_last, block)) {
+                        mismatch.cancel();
+                        return;
+                    }
+                    chunk_first += block;
+                    back_last -= block;
+                }
+            });
+
+            return !mismatch.cancelled();
+        }
+
+    } // namespace detail
+
+    /**
+     * Parallel is_palindrome: the first half is split into chunks, each compared with
+     * its mirrored chunk in the second half, and a mismatch in any pair stops the others
+     */
+    template<
+        typename ExecutionPolicy,
+        typename BiDirIt,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    bool is_palindrome(ExecutionPolicy&& policy, BiDirIt first, BiDirIt last) {
+        if constexpr (detail::runs_parallel_v<ExecutionPolicy, BiDirIt> && !detail::is_xrange_iterator_v<BiDirIt>)
+            return detail::parallel_is_palindrome(detail::executor_of(policy), first, last);
+        else
+            return py_algo::is_palindrome(first, last);
+    }
+
+#endif
+
+
+#if __cplusplus >= 201103L
+
+    // Declaring templates
+
+    template<typename T>
+    class xrange;
+
+    template<typename T>
+    class xrange_iterator;
+
+    template<typename T>
+    constexpr bool operator==(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+
+    template<typename T>
+    constexpr bool operator!=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+
+    template<typename T>
+    constexpr bool operator<(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+
+    template<typename T>
+    constexpr bool operator>(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+
+    template<typename T>
+    constexpr bool operator<=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+
+    template<typename T>
+    constexpr bool operator>=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+
+    template<typename T>
+    constexpr xrange_iterator<T> operator+(typename xrange_iterator<T>::difference_type _n,
+                                 const xrange_iterator<T>& _iter) noexcept;
+
+#if __cplusplus >= 202002L
+    template<typename T>
+    class xrange_sentinel;
+#endif
+
+    // Implementation
+
+    /**
+     * Random-access iterator over an arithmetic progression. It keeps the index of the
+     * current element and computes start + index * step on dereference, so it does not
+     * refer to its xrange and can be moved by any distance in O(1).
+     */
+    template<typename T>
+    class xrange_iterator {
+    public:
+        typedef std::remove_cv_t<T> value_type;
+        typedef value_type reference;
+        typedef void pointer;
+        typedef std::ptrdiff_t difference_type;
+        [[maybe_unused]] typedef std::random_access_iterator_tag iterator_category;
+
+    private:
+        value_type stored_start;
+        value_type stored_step;
+        difference_type stored_index;
+
+    public:
+        constexpr explicit xrange_iterator() noexcept
+            : stored_start(), stored_step(), stored_index() {}
+
+        constexpr explicit xrange_iterator(value_type _start, value_type _step, difference_type _index) noexcept
+            : stored_start(_start), stored_step(_step), stored_index(_index) {}
+
+        constexpr reference operator*() const noexcept {
+            return detail::progression_value(stored_start, stored_step, stored_index);
+        }
+
+        constexpr reference operator[](difference_type _n) const noexcept {
+            return detail::progression_value(stored_start, stored_step, stored_index + _n);
+        }
+
+        friend struct detail::xrange_access;
+
+        constexpr xrange_iterator& operator++() noexcept {
+            ++stored_index;
+            return *this;
+        }
+
+        constexpr xrange_iterator operator++(int) noexcept {
+            auto old_iter = *this;
+            ++stored_index;
+            return old_iter;
+        }
+
+        constexpr xrange_iterator& operator--() noexcept {
+            --stored_index;
+            return *this;
+        }
+
+        constexpr xrange_iterator operator--(int) noexcept {
+            auto old_iter = *this;
+            --stored_index;
+            return old_iter;
+        }
+
+        constexpr xrange_iterator& operator+=(difference_type _n) noexcept {
+            stored_index += _n;
+            return *this;
+        }
+
+        constexpr xrange_iterator& operator-=(difference_type _n) noexcept {
+            stored_index -= _n;
+            return *this;
+        }
+
+        constexpr xrange_iterator operator+(difference_type _n) const noexcept {
+            return xrange_iterator(stored_start, stored_step, stored_index + _n);
+        }
+
+        constexpr xrange_iterator operator-(difference_type _n) const noexcept {
+            return xrange_iterator(stored_start, stored_step, stored_index - _n);
+        }
+
+        constexpr difference_type operator-(const xrange_iterator& _iter) const noexcept {
+            return stored_index - _iter.stored_index;
+        }
+
+        friend constexpr bool operator== <T>(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+
+        friend constexpr bool operator!= <T>(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+
+        friend constexpr bool operator< <T>(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+
+        friend constexpr bool operator> <T>(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+
+        friend constexpr bool operator<= <T>(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+
+        friend constexpr bool operator>= <T>(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept;
+    };
+
+#if __cplusplus >= 202002L
+
+    /**
+     * End of an xrange as a bare index. Comparing an iterator with it is one integer
+     * compare, and the distance to it is what std::ranges needs for sized_sentinel_for.
+     */
+    template<typename T>
+    class xrange_sentinel {
+    public:
+        typedef std::ptrdiff_t difference_type;
+
+    private:
+        difference_type stored_index;
+
+    public:
+        constexpr xrange_sentinel() noexcept
+            : stored_index() {}
+
+        constexpr explicit xrange_sentinel(difference_type _index) noexcept
+            : stored_index(_index) {}
+
+        friend constexpr bool operator==(const xrange_iterator<T>& _iter, const xrange_sentinel& _end) noexcept {
+            return detail::xrange_access::index(_iter) == _end.stored_index;
+        }
+
+        friend constexpr difference_type operator-(const xrange_sentinel& _end, const xrange_iterator<T>& _iter) noexcept {
+            return _end.stored_index - detail::xrange_access::index(_iter);
+        }
+
+        friend constexpr difference_type operator-(const xrange_iterator<T>& _iter, const xrange_sentinel& _end) noexcept {
+            return detail::xrange_access::index(_iter) - _end.stored_index;
+        }
+    };
+
+#endif
+
+    /**
+     * Python-like xrange over [start, end) with some step. The number of elements is
+     * computed once in the constructor, so size(), operator[] and iterator distance are O(1)
+     * and the range can be cut into equal shards without walking it.
+     */
+    template<typename T>
+    class xrange {
+    public:
+        typedef T value_type;
+        typedef const value_type const_value_type;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef xrange_iterator<value_type> iterator;
+        typedef xrange_iterator<value_type> const_iterator;
+#if __cplusplus >= 202002L
+        typedef xrange_sentinel<value_type> sentinel;
+#endif
+    private:
+        value_type start;
+        value_type finish;
+        value_type step;
+        // Index in the progression start + k * step of the first element; non-zero for parts of a split range
+        difference_type offset;
+        difference_type count;
+
+        static constexpr difference_type count_elements(const_value_type& _start, const_value_type& _end,
+                                              const_value_type& _step) {
+            if (_step == value_type())
+                throw std::invalid_argument("xrange step must not be zero");
+
+            if constexpr (std::is_integral_v<value_type>) {
+                typedef std::make_unsigned_t<value_type> unsigned_type;
+                unsigned_type distance, stride;
+                if (_step > value_type()) {
+                    if (_end <= _start)
+                        return 0;
+                    distance = static_cast<unsigned_type>(static_cast<unsigned_type>(_end) - static_cast<unsigned_type>(_start));
+                    stride = static_cast<unsigned_type>(_step);
+                } else {
+                    if (_start <= _end)
+                        return 0;
+                    distance = static_cast<unsigned_type>(static_cast<unsigned_type>(_start) - static_cast<unsigned_type>(_end));
+                    stride = static_cast<unsigned_type>(unsigned_type() - static_cast<unsigned_type>(_step));
+                }
+                // Ranges of the wide unsigned types can hold more elements than difference_type counts
+                auto elements = static_cast<std::uintmax_t>((distance - 1) / stride) + 1;
+                if (elements > static_cast<std::uintmax_t>(PTRDIFF_MAX))
+                    throw std::length_error("xrange has too many elements");
+
+                return static_cast<difference_type>(elements);
+            } else {
+                auto estimate = (_end - _start) / _step;
+                if (estimate != estimate)
+                    return 0;
+                if (!(estimate < static_cast<value_type>(PTRDIFF_MAX / 4)))
+                    throw std::length_error("xrange has too many elements");
+
+                // The quotient may be off by a rounding, so count the indices whose element, computed
+                // exactly as the iterator does, is still before _end. They form a prefix.
+                auto before_end = [&](difference_type _index) {
+                    auto value = static_cast<value_type>(_start + _index * _step);
+                    return _step > value_type() ? value < _end : value > _end;
+                };
+                difference_type guess = estimate > 0 ? static_cast<difference_type>(estimate) : 0;
+                difference_type low, high, distance = 1;
+                if (before_end(guess)) {
+                    while (before_end(guess + distance))
+                        distance *= 2;
+                    low = guess + distance / 2 + 1;
+                    high = guess + distance;
+                } else {
+                    while (guess - distance >= 0 && !before_end(guess - distance))
+                        distance *= 2;
+                    low = std::max<difference_type>(guess - distance + 1, 0);
+                    high = guess - distance / 2;
+                }
+                while (low < high) {
+                    auto middle = low + (high - low) / 2;
+                    if (before_end(middle))
+                        low = middle + 1;
+                    else
+                        high = middle;
+                }
+
+                return low;
+            }
+        }
+
+        // Elements [_offset, _offset + _count) of the progression, for slice() and intersect()
+        constexpr xrange(const_value_type& _start, const_value_type& _step, difference_type _offset, difference_type _count) noexcept
+            : start(_start), finish(detail::progression_value(_start, _step, _offset + _count)), step(_step),
+              offset(_offset), count(_count) {}
+
+    public:
+        constexpr explicit xrange(const_value_type& _end)
+            : start(), finish(_end), step(1), offset(0), count(count_elements(start, finish, step)) {}
+
+        constexpr explicit xrange(const_value_type& start, const_value_type& _end)
+            : start(start), finish(_end), step(1), offset(0), count(count_elements(start, finish, step)) {}
+
+        constexpr explicit xrange(const_value_type& start, const_value_type& _end, const_value_type& step)
+            : start(start), finish(_end), step(step), offset(0), count(count_elements(start, finish, step)) {}
+
+        constexpr iterator begin() const noexcept {
+            return iterator(start, step, offset);
+        }
+
+        [[maybe_unused]] constexpr const_iterator cbegin() const noexcept {
+            return const_iterator(start, step, offset);
+        }
+
+        constexpr iterator end() const noexcept {
+            return iterator(start, step, offset + count);
+        }
+
+        [[maybe_unused]] constexpr const_iterator cend() const noexcept {
+            return const_iterator(start, step, offset + count);
+        }
+
+#if __cplusplus >= 202002L
+        // end() for loops and std::ranges::subrange that only need to know where to stop
+        constexpr sentinel end_sentinel() const noexcept {
+            return sentinel(offset + count);
+        }
+#endif
+
+        constexpr size_type size() const noexcept {
+            return static_cast<size_type>(count);
+        }
+
+        constexpr bool empty() const noexcept {
+            return count == 0;
+        }
+
+        constexpr value_type operator[](size_type _n) const noexcept {
+            return begin()[static_cast<difference_type>(_n)];
+        }
+
+        // Analytic queries: O(1) answers from start, step and the element count
+
+        /**
+         * Checked element access
+         *
+         * @throws std::out_of_range if _n >= size()
+         */
+        constexpr value_type nth(size_type _n) const {
+            if (_n >= size())
+                throw std::out_of_range("xrange::nth index out of range");
+
+            return (*this)[_n];
+        }
+
+        /**
+         * Position of _value in the range, or size() if the range does not yield it
+         */
+        constexpr size_type index_of(const_value_type& _value) const noexcept {
+            auto index = detail::progression_index<value_type>(start, step, _value, offset, offset + count);
+            return index >= 0 ? static_cast<size_type>(index - offset) : size();
+        }
+
+        constexpr bool contains(const_value_type& _value) const noexcept {
+            return index_of(_value) != size();
+        }
+
+        /**
+         * Writes the elements to _out and returns the iterator past the last one written.
+         * Contiguous float and double outputs are filled in vector blocks that compute
+         * every element the same way as the iterator.
+         */
+        template<typename OutputIt>
+        constexpr OutputIt fill(OutputIt _out) const {
+#ifdef PY_ALGO_SIMD_DISPATCH
+            if constexpr (std::is_floating_point_v<value_type> && detail::simd::is_dispatchable_v<OutputIt, value_type>) {
+                if (!std::is_constant_evaluated()) {
+                    detail::simd::fill_progression(std::to_address(_out), start, step, offset, size());
+                    return _out + count;
+                }
+            }
+#endif
+            for (auto value: *this)
+                *_out++ = value;
+
+            return _out;
+        }
+
+        constexpr std::vector<value_type> to_vector() const {
+            std::vector<value_type> values(size());
+            fill(values.begin());
+            return values;
+        }
+
+        constexpr value_type sum() const noexcept {
+            if (count == 0)
+                return value_type();
+
+            // count * start + step * count * (count - 1) / 2, halving whichever factor is even
+            if constexpr (std::is_integral_v<value_type>) {
+                // Integers add up modulo 2^n in unsigned arithmetic, at least as wide as unsigned
+                // int so the promotions cannot overflow, and are cast back once at the end
+                typedef std::make_unsigned_t<std::common_type_t<value_type, int>> unsigned_type;
+                auto n = static_cast<std::make_unsigned_t<difference_type>>(count);
+                auto pairs = n % 2 == 0 ? (n / 2) * (n - 1) : n * ((n - 1) / 2);
+                return static_cast<value_type>(static_cast<unsigned_type>(n) * static_cast<unsigned_type>((*this)[0]) +
+                                               static_cast<unsigned_type>(pairs) * static_cast<unsigned_type>(step));
+            } else {
+                auto pairs = count % 2 == 0 ? (count / 2) * (count - 1) : count * ((count - 1) / 2);
+                return static_cast<value_type>(static_cast<value_type>(count) * (*this)[0] + static_cast<value_type>(pairs) * step);
+            }
+        }
+
+        // Splitting. Parts keep the start and step of this range and only narrow the index
+        // window, so every element, floating point included, is computed exactly as here.
+
+        /**
+         * Elements with positions in [_first, _last)
+         *
+         * @throws std::out_of_range if _first > _last or _last > size()
+         */
+        constexpr xrange slice(size_type _first, size_type _last) const {
+            if (_first > _last || _last > size())
+                throw std::out_of_range("xrange::slice bounds out of range");
+
+            return xrange(start, step, offset + static_cast<difference_type>(_first),
+                          static_cast<difference_type>(_last - _first));
+        }
+
+        /**
+         * Consecutive parts of _n elements each, the last one possibly shorter
+         *
+         * @throws std::invalid_argument if _n is zero
+         */
+        constexpr std::vector<xrange> chunks(size_type _n) const {
+            if (_n == 0)
+                throw std::invalid_argument("xrange::chunks size must not be zero");
+
+            std::vector<xrange> parts;
+            parts.reserve((size() + _n - 1) / _n);
+            for (size_type first = 0; first < size(); first += _n)
+                parts.push_back(slice(first, std::min(first + _n, size())));
+
+            return parts;
+        }
+
+        /**
+         * Exactly _k consecutive parts whose sizes differ by at most one, larger parts first.
+         * Parts are empty when the range has fewer than _k elements.
+         *
+         * @throws std::invalid_argument if _k is zero
+         */
+        constexpr std::vector<xrange> split(size_type _k) const {
+            if (_k == 0)
+                throw std::invalid_argument("xrange::split needs at least one part");
+
+            std::vector<xrange> parts;
+            parts.reserve(_k);
+            for (size_type i = 0; i < _k; ++i)
+                parts.push_back(split_part(i, _k));
+
+            return parts;
+        }
+
+        // Part _i of split(_k) without building the others
+        constexpr xrange split_part(size_type _i, size_type _k) const {
+            auto base = size() / _k, extra = size() % _k;
+            auto first = _i * base + std::min(_i, extra);
+            return slice(first, first + base + (_i < extra ? 1 : 0));
+        }
+
+        /**
+         * Elements yielded by both ranges. The result follows the direction of this range
+         * and steps by the least common multiple of both steps.
+         *
+         * @throws std::out_of_range if several elements are common and that multiple is not a valid step
+         */
+        template<typename U = value_type, typename = std::enable_if_t<std::is_integral_v<U> &&
+                                                                      !std::is_void_v<detail::wide_unsigned_t<U>>>>
+        constexpr xrange intersect(const xrange& _other) const {
+            if (empty() || _other.empty())
+                return xrange(start, start);
+
+            // Values are mapped in order onto [0, 2^n), so bounds, residues and steps are unsigned
+            // and the product of any two of them fits wide_type
+            typedef std::make_unsigned_t<value_type> unsigned_type;
+            typedef detail::wide_unsigned_t<value_type> wide_type;
+            constexpr unsigned_type sign = std::is_signed_v<value_type>
+                ? static_cast<unsigned_type>(unsigned_type(1) << (8 * sizeof(value_type) - 1)) : unsigned_type();
+            auto ordinal = [](value_type _x) {
+                return wide_type(static_cast<unsigned_type>(static_cast<unsigned_type>(_x) ^ sign));
+            };
+            auto value = [](wide_type _ordinal) {
+                return static_cast<value_type>(static_cast<unsigned_type>(static_cast<unsigned_type>(_ordinal) ^ sign));
+            };
+            auto modulus = [](value_type _step) {
+                auto bits = static_cast<unsigned_type>(_step);
+                return wide_type(_step > value_type() ? bits : static_cast<unsigned_type>(unsigned_type() - bits));
+            };
+            auto bounds = [&ordinal](const xrange& _range) {
+                auto first = ordinal(_range[0]), last = ordinal(_range[_range.size() - 1]);
+                return std::make_pair(std::min(first, last), std::max(first, last));
+            };
+            auto [low_a, high_a] = bounds(*this);
+            auto [low_b, high_b] = bounds(_other);
+            wide_type low = std::max(low_a, low_b);
+            wide_type high = std::min(high_a, high_b);
+            if (low > high)
+                return xrange(start, start);
+
+            // Offset t >= 0 of the first common element from low: t = residue_a (mod |step|) and
+            // t = residue_b (mod |other.step|)
+            wide_type modulus_a = modulus(step), modulus_b = modulus(_other.step);
+            wide_type residue_a = (modulus_a - (low - low_a) % modulus_a) % modulus_a;
+            wide_type residue_b = (modulus_b - (low - low_b) % modulus_b) % modulus_b;
+            wide_type divisor = modulus_a, remainder = modulus_b;
+            while (remainder != 0)
+                divisor = std::exchange(remainder, divisor % remainder);
+            if ((residue_a > residue_b ? residue_a - residue_b : residue_b - residue_a) % divisor != 0)
+                return xrange(start, start);
+
+            // t = residue_a + |step| * k, with k the inverse of |step| / divisor modulo reduced_b,
+            // kept non-negative through the extended Euclidean algorithm, times the residue gap
+            wide_type reduced_b = modulus_b / divisor;
+            wide_type old_r = (modulus_a / divisor) % reduced_b, r = reduced_b, old_s = 1, s = 0;
+            while (r != 0) {
+                wide_type quotient = old_r / r;
+                old_r = std::exchange(r, old_r - quotient * r);
+                old_s = std::exchange(s, (old_s + reduced_b - quotient * s % reduced_b) % reduced_b);
+            }
+            wide_type gap = (residue_b + modulus_b - residue_a % modulus_b) % modulus_b / divisor;
+            wide_type first = residue_a + modulus_a * (gap * old_s % reduced_b);
+            if (first > high - low)
+                return xrange(start, start);
+
+            wide_type lcm = modulus_a * reduced_b;
+            auto common = static_cast<difference_type>((high - low - first) / lcm + 1);
+            first += low;
+            if (common == 1)
+                return xrange(value(first), step, 0, 1);
+            // Common elements lcm apart, which value_type must hold as a step in this direction
+            if (step > value_type()) {
+                if (lcm > wide_type(std::numeric_limits<value_type>::max()))
+                    throw std::out_of_range("xrange::intersect step does not fit the element type");
+                return xrange(value(first), static_cast<value_type>(lcm), 0, common);
+            } else {
+                if (lcm > wide_type(sign))
+                    throw std::out_of_range("xrange::intersect step does not fit the element type");
+                return xrange(value(first + wide_type(common - 1) * lcm),
+                              static_cast<value_type>(unsigned_type() - static_cast<unsigned_type>(lcm)), 0, common);
+            }
+        }
+    };
+
+    template<typename T>
+    constexpr bool operator==(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept {
+        return _l.stored_index == _r.stored_index;
+    }
+
+    template<typename T>
+    constexpr bool operator!=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept {
+        return _l.stored_index != _r.stored_index;
+    }
+
+    template<typename T>
+    constexpr bool operator<(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept {
+        return _l.stored_index < _r.stored_index;
+    }
+
+    template<typename T>
+    constexpr bool operator>(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept {
+        return _l.stored_index > _r.stored_index;
+    }
+
+    template<typename T>
+    constexpr bool operator<=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept {
+        return _l.stored_index <= _r.stored_index;
+    }
+
+    template<typename T>
+    constexpr bool operator>=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) noexcept {
+        return _l.stored_index >= _r.stored_index;
+    }
+
+    template<typename T>
+    constexpr xrange_iterator<T> operator+(typename xrange_iterator<T>::difference_type _n,
+                                 const xrange_iterator<T>& _iter) noexcept {
+        return _iter + _n;
+    }
+
+    /**
+     * How parallel_for hands parts of the range to threads
+     */
+    enum class schedule {
+        // One contiguous part per thread, split(concurrency) style; cheapest for uniform work
+        static_split,
+        // Shrinking parts: half of the remaining elements per thread, but at least the grain
+        guided,
+        // Parts of grain elements claimed one at a time; best for uneven work
+        dynamic
+    };
+
+    /**
+     * Calls _fn(x) for every element of _range on the policy's executor. Elements are computed
+     * from their index in _range, so floating point values match sequential iteration.
+     * The first exception thrown by _fn is rethrown once all threads stopped.
+     *
+     * @param _schedule how the range is split between threads
+     * @param _grain smallest part handed to a thread, or 0 to pick one from the range size
+     */
+    template<
+        typename ExecutionPolicy,
+        typename T,
+        typename Function,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    void parallel_for(ExecutionPolicy&& policy, const xrange<T>& _range, Function _fn,
+                      schedule _schedule = schedule::static_split, std::size_t _grain = 0) {
+        if constexpr (std::is_same_v<std::remove_cv_t<std::remove_reference_t<ExecutionPolicy>>, execution::sequenced_policy>) {
+            for (auto x: _range)
+                _fn(x);
+            return;
+        }
+
+        auto& pool = detail::executor_of(policy);
+        std::size_t size = _range.size();
+        std::size_t threads = pool.concurrency();
+        auto run_part = [&_range, &_fn](std::size_t _first, std::size_t _last) {
+            for (auto x: _range.slice(_first, _last))
+                _fn(x);
+        };
+
+        switch (_schedule) {
+            case schedule::static_split: {
+                std::size_t parts = std::min(threads, _grain == 0 ? size : (size + _grain - 1) / _grain);
+                if (parts == 0)
+                    return;
+                pool.run(parts, [&](std::size_t i) {
+                    auto part = _range.split_part(i, parts);
+                    for (auto x: part)
+                        _fn(x);
+                });
+                break;
+            }
+            case schedule::guided:
+            case schedule::dynamic: {
+                std::size_t grain = std::max<std::size_t>(1, _grain != 0 ? _grain : size / (8 * threads));
+                std::atomic<std::size_t> next{0};
+                pool.run(std::min(threads, (size + grain - 1) / grain), [&](std::size_t) {
+                    for (;;) {
+                        std::size_t first = next.load(std::memory_order_relaxed);
+                        std::size_t length;
+                        do {
+                            if (first >= size)
+                                return;
+                            length = _schedule == schedule::dynamic
+                                     ? grain : std::max(grain, (size - first) / (2 * threads));
+                            length = std::min(length, size - first);
+                        } while (!next.compare_exchange_weak(first, first + length, std::memory_order_relaxed));
+                        run_part(first, first + length);
+                    }
+                });
+                break;
+            }
+        }
+    }
+
+    template<typename T, typename Function>
+    void parallel_for(const xrange<T>& _range, Function _fn, schedule _schedule = schedule::static_split,
+                      std::size_t _grain = 0) {
+        py_algo::parallel_for(execution::par, _range, std::move(_fn), _schedule, _grain);
+    }
+
+    /**
+     * Calls _fn(i, _range[i]) for every index i of a random access range on the policy's
+     * executor. Threads get index ranges as in parallel_for, and _fn receives the element
+     * by reference, so it can update the range in place.
+     */
+    template<
+        typename ExecutionPolicy,
+        typename Range,
+        typename Function,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    void parallel_for_each_indexed(ExecutionPolicy&& policy, Range&& _range, Function _fn,
+                                   schedule _schedule = schedule::static_split, std::size_t _grain = 0) {
+        auto first = std::begin(_range);
+        static_assert(detail::is_random_access_v<decltype(first)>, "parallel_for_each_indexed needs a random access range");
+
+        auto size = static_cast<std::size_t>(std::end(_range) - first);
+        py_algo::parallel_for(std::forward<ExecutionPolicy>(policy), xrange<std::size_t>(size), [first, &_fn](std::size_t i) {
+            _fn(i, first[static_cast<std::ptrdiff_t>(i)]);
+        }, _schedule, _grain);
+    }
+
+    template<typename Range, typename Function>
+    void parallel_for_each_indexed(Range&& _range, Function _fn, schedule _schedule = schedule::static_split,
+                                   std::size_t _grain = 0) {
+        py_algo::parallel_for_each_indexed(execution::par, std::forward<Range>(_range), std::move(_fn), _schedule, _grain);
+    }
+
+#endif
+
+#if __cplusplus >= 201703L
+
+    // Declaring templates
+
+    template<class... Containers>
+    class zip;
+
+    template<class... Containers>
+    class zip_iterator;
+
+    template<class... References>
+    class zip_reference;
 
-#if __cplusplus < 201703L
+    template<class... Containers>
+    constexpr bool operator==(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
 
-    template<typename BiDirIt>
-    bool is_palindrome(BiDirIt first, BiDirIt last) {
-        if (first == last)
-            return true;
+    template<class... Containers>
+    constexpr bool operator!=(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
 
-        while (first < --last) {
-            if (*first != *last)
-                return false;
-            first++;
-        }
+    template<class... Containers>
+    constexpr bool operator<(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
 
-        return true;
-    }
+    template<class... Containers>
+    constexpr bool operator>(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
 
-#else
+    template<class... Containers>
+    constexpr bool operator<=(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
 
-    template<
-        typename BiDirIt,
-        typename = std::enable_if_t<std::is_base_of_v<std::bidirectional_iterator_tag,
-            typename std::iterator_traits<BiDirIt>::iterator_category>>>
-    constexpr bool is_palindrome(BiDirIt first, BiDirIt last) {
-        if (first == last)
-            return true;
+    template<class... Containers>
+    constexpr bool operator>=(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
 
-        while (first < --last) {
-            if (*first != *last)
-                return false;
-            first++;
+#if __cplusplus >= 202002L
+    template<class... Containers>
+    class zip_sentinel;
+#endif
+
+    namespace detail {
+
+        // Iterator of a possibly const-qualified container
+        template<class Container>
+        using container_iterator_t = decltype(std::begin(std::declval<Container&>()));
+
+        template<class Tag, class... Iterators>
+        inline constexpr bool all_iterators_are_v = (std::is_base_of_v<Tag,
+            typename std::iterator_traits<Iterators>::iterator_category> && ...);
+
+        // Strongest category every one of the iterators provides
+        template<class... Iterators>
+        using common_iterator_category_t =
+            std::conditional_t<all_iterators_are_v<std::random_access_iterator_tag, Iterators...>, std::random_access_iterator_tag,
+            std::conditional_t<all_iterators_are_v<std::bidirectional_iterator_tag, Iterators...>, std::bidirectional_iterator_tag,
+            std::conditional_t<all_iterators_are_v<std::forward_iterator_tag, Iterators...>, std::forward_iterator_tag,
+                std::input_iterator_tag>>>;
+
+        template<class Container, class = void>
+        struct has_size : std::false_type {};
+
+        template<class Container>
+        struct has_size<Container, std::void_t<decltype(std::size(std::declval<Container&>()))>> : std::true_type {};
+
+        // Containers whose length is known without walking them
+        template<class Container>
+        inline constexpr bool is_counted_v = has_size<Container>::value ||
+            all_iterators_are_v<std::random_access_iterator_tag, container_iterator_t<Container>>;
+
+        template<class Container>
+        constexpr std::ptrdiff_t container_length(Container& _container) {
+            if constexpr (all_iterators_are_v<std::random_access_iterator_tag, container_iterator_t<Container>>)
+                return static_cast<std::ptrdiff_t>(std::end(_container) - std::begin(_container));
+            else if constexpr (has_size<Container>::value)
+                return static_cast<std::ptrdiff_t>(std::size(_container));
+            else
+                return static_cast<std::ptrdiff_t>(std::distance(std::begin(_container), std::end(_container)));
         }
 
-        return true;
-    }
+    } // namespace detail
 
-#endif
+    // Implementation
+
+    /**
+     * Proxy that zip_iterator yields: a std::tuple of references into the zipped containers.
+     * Assigning to it or swapping two of them writes through to the containers, which lets
+     * std::sort, std::stable_sort and std::partition reorder all columns together.
+     */
+    template<class... References>
+    class zip_reference : public std::tuple<References...> {
+    public:
+        typedef std::tuple<References...> base_type;
 
+        using base_type::base_type;
 
-#if __cplusplus >= 201103L
+        constexpr zip_reference(const zip_reference&) = default;
 
-    // Declaring templates
+        constexpr zip_reference& operator=(const zip_reference& _other) {
+            base_type::operator=(static_cast<const base_type&>(_other));
 
-    template<typename T>
-    class xrange;
+            return *this;
+        }
 
-    template<typename T>
-    class xrange_iterator;
+        constexpr zip_reference& operator=(zip_reference&& _other) {
+            assign(std::move(_other), std::index_sequence_for<References...>());
 
-    template<typename T>
-    bool operator==(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r);
+            return *this;
+        }
 
-    template<typename T>
-    bool operator!=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r);
+        template<class... Values>
+        constexpr zip_reference& operator=(const std::tuple<Values...>& _values) {
+            base_type::operator=(_values);
 
-    template<typename T>
-    bool operator<(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r);
+            return *this;
+        }
 
-    template<typename T>
-    bool operator>(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r);
+        template<class... Values>
+        constexpr zip_reference& operator=(std::tuple<Values...>&& _values) {
+            base_type::operator=(std::move(_values));
 
-    template<typename T>
-    bool operator<=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r);
+            return *this;
+        }
 
-    template<typename T>
-    bool operator>=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r);
+        friend constexpr void swap(zip_reference _l, zip_reference _r) {
+            swap_elements(_l, _r, std::index_sequence_for<References...>());
+        }
 
-    // Implementation
+    private:
+        // Moves the referred elements, not the references
+        template<std::size_t... I>
+        constexpr void assign(zip_reference&& _other, std::index_sequence<I...>) {
+            ((std::get<I>(*this) = std::move(std::get<I>(_other))), ...);
+        }
 
-    template<typename T>
-    class xrange_iterator {
+        template<std::size_t... I>
+        static constexpr void swap_elements(zip_reference& _l, zip_reference& _r, std::index_sequence<I...>) {
+            using std::swap;
+            (swap(std::get<I>(_l), std::get<I>(_r)), ...);
+        }
+    };
+
+    /**
+     * Iterator over several containers at once. Dereferencing yields a zip_reference,
+     * a tuple of references into the containers, so no element is copied and the elements
+     * of non-const containers can be modified through it. The iterator is as strong as
+     * the weakest of the containers' iterators, up to random access. It also counts its
+     * position, and when every container knows its length (counted) the position alone
+     * decides comparisons and distances.
+     */
+    template<class... Containers>
+    class zip_iterator {
     public:
-        typedef T value_type;
-        typedef value_type* pointer;
-        typedef typename std::iterator_traits<pointer>::reference reference;
-        [[maybe_unused]] typedef typename std::iterator_traits<pointer>::difference_type difference_type;
-        typedef const xrange<value_type>* range_const_pointer;
-        [[maybe_unused]] typedef std::input_iterator_tag iterator_category;
+        typedef std::tuple<detail::container_iterator_t<Containers>...> iterator_tuple;
+        typedef std::tuple<typename std::iterator_traits<detail::container_iterator_t<Containers>>::value_type...> value_type;
+        typedef zip_reference<typename std::iterator_traits<detail::container_iterator_t<Containers>>::reference...> reference;
+        typedef void pointer;
+        typedef std::ptrdiff_t difference_type;
+        [[maybe_unused]] typedef detail::common_iterator_category_t<detail::container_iterator_t<Containers>...> iterator_category;
+
+        static constexpr bool counted = (detail::is_counted_v<Containers> && ...);
 
     private:
-        value_type stored_value;
-        range_const_pointer stored_xrange;
+        iterator_tuple iters;
+        difference_type stored_index;
 
     public:
-        explicit xrange_iterator() noexcept
-            : stored_value(), stored_xrange() {}
+        constexpr explicit zip_iterator() noexcept
+            : iters(), stored_index() {}
+
+        constexpr explicit zip_iterator(difference_type _index, detail::container_iterator_t<Containers>... _iters) noexcept
+            : iters(_iters...), stored_index(_index) {}
+
+        constexpr const iterator_tuple& base() const noexcept {
+            return iters;
+        }
+
+        // Position from the beginning of the zip
+        constexpr difference_type index() const noexcept {
+            return stored_index;
+        }
 
-        xrange_iterator(const xrange_iterator& _iter) noexcept
-            : stored_value(_iter.stored_value), stored_xrange(_iter.stored_xrange) {}
+        constexpr reference operator*() const {
+            return std::apply([](const auto&... _iter) { return reference(*_iter...); }, iters);
+        }
+
+        constexpr reference operator[](difference_type _n) const {
+            return *(*this + _n);
+        }
 
-        xrange_iterator& operator=(const xrange_iterator& _iter) noexcept {
-            stored_value = _iter.stored_value;
-            stored_xrange = _iter.stored_xrange;
+        constexpr zip_iterator& operator++() {
+            std::apply([](auto&... _iter) { (++_iter, ...); }, iters);
+            ++stored_index;
 
             return *this;
         }
 
-        explicit xrange_iterator(value_type _value, range_const_pointer _xrange) noexcept {
-            stored_value = _value;
-            stored_xrange = _xrange;
+        constexpr zip_iterator operator++(int) {
+            auto old_iter = *this;
+            ++*this;
+
+            return old_iter;
         }
 
-        reference operator*() noexcept {
-            return stored_value;
+        constexpr zip_iterator& operator--() {
+            std::apply([](auto&... _iter) { (--_iter, ...); }, iters);
+            --stored_index;
+
+            return *this;
         }
 
-        pointer operator->() noexcept {
-            return &stored_value;
+        constexpr zip_iterator operator--(int) {
+            auto old_iter = *this;
+            --*this;
+
+            return old_iter;
         }
 
-        xrange_iterator& operator++() noexcept {
-            if (stored_xrange->has_step)
-                if (stored_xrange->finish - stored_value >= stored_xrange->step)
-                    stored_value += stored_xrange->step;
-                else
-                    stored_value = stored_xrange->finish;
-            else if (stored_value < stored_xrange->finish)
-                stored_value++;
+        constexpr zip_iterator& operator+=(difference_type _n) {
+            std::apply([_n](auto&... _iter) { ((_iter += _n), ...); }, iters);
+            stored_index += _n;
 
             return *this;
         }
 
-        xrange_iterator operator++(int) noexcept {
-            auto old_value = stored_value;
-            if (stored_xrange->has_step)
-                if (stored_xrange->finish - stored_value >= stored_xrange->step)
-                    stored_value += stored_xrange->step;
-                else
-                    stored_value = stored_xrange->finish;
-            else if (stored_value < stored_xrange->finish)
-                stored_value++;
+        constexpr zip_iterator& operator-=(difference_type _n) {
+            return *this += -_n;
+        }
+
+        constexpr zip_iterator operator+(difference_type _n) const {
+            auto iter = *this;
+
+            return iter += _n;
+        }
+
+        friend constexpr zip_iterator operator+(difference_type _n, const zip_iterator& _iter) {
+            return _iter + _n;
+        }
+
+        constexpr zip_iterator operator-(difference_type _n) const {
+            auto iter = *this;
 
-            return xrange_iterator(old_value, stored_xrange);
+            return iter -= _n;
         }
 
-        friend bool operator== <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
+        constexpr difference_type operator-(const zip_iterator& _iter) const {
+            return stored_index - _iter.stored_index;
+        }
+
+        friend constexpr bool operator== <Containers...>(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
 
-        friend bool operator!= <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
+        friend constexpr bool operator!= <Containers...>(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
 
-        friend bool operator< <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
+        friend constexpr bool operator< <Containers...>(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
 
-        friend bool operator> <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
+        friend constexpr bool operator> <Containers...>(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
 
-        friend bool operator<= <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
+        friend constexpr bool operator<= <Containers...>(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
 
-        friend bool operator>= <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
+        friend constexpr bool operator>= <Containers...>(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r);
     };
 
-    template<typename T>
-    class xrange {
+#if __cplusplus >= 202002L
+
+    /**
+     * End of a zip. A counted zip ends at its common length, so the sentinel keeps that
+     * length only and a comparison is one integer compare. Other zips have to compare
+     * the end of every container.
+     */
+    template<class... Containers>
+    class zip_sentinel {
     public:
-        typedef T value_type;
-        typedef const value_type const_value_type;
-        typedef xrange_iterator<value_type> iterator;
-        typedef xrange_iterator<const_value_type> const_iterator;
+        typedef std::ptrdiff_t difference_type;
+
     private:
-        const_value_type start;
-        const_value_type finish;
-        const_value_type step;
-        bool has_step{false};
-    public:
-        explicit xrange(const_value_type& _end)
-            : start(), finish(_end), step() {}
+        static constexpr bool counted = zip_iterator<Containers...>::counted;
 
-        explicit xrange(const_value_type& start, const_value_type& _end)
-            : start(start), finish(_end), step() {}
+        typedef typename zip_iterator<Containers...>::iterator_tuple iterator_tuple;
+        typedef std::conditional_t<counted, difference_type, iterator_tuple> end_type;
 
-        explicit xrange(const_value_type& start, const_value_type& _end, const_value_type& step)
-            : start(start), finish(_end), step(step), has_step(true) {}
+        end_type stored_end;
 
-        iterator begin() noexcept {
-            return iterator(start, this);
+    public:
+        constexpr zip_sentinel()
+            : stored_end() {}
+
+        constexpr explicit zip_sentinel(const zip_iterator<Containers...>& _end)
+            : stored_end(end_of(_end)) {}
+
+        friend constexpr bool operator==(const zip_iterator<Containers...>& _iter, const zip_sentinel& _end) {
+            if constexpr (counted) {
+                return _iter.index() == _end.stored_end;
+            } else {
+                return std::apply([&_end](const auto&... _iter_part) {
+                    return std::apply([&](const auto&... _end_part) { return ((_iter_part == _end_part) || ...); },
+                                      _end.stored_end);
+                }, _iter.base());
+            }
         }
 
-        const_iterator begin() const noexcept {
-            return const_iterator(start, this);
+        friend constexpr difference_type operator-(const zip_sentinel& _end, const zip_iterator<Containers...>& _iter)
+            requires counted {
+            return _end.stored_end - _iter.index();
         }
 
-        [[maybe_unused]] const_iterator cbegin() const noexcept {
-            return const_iterator(start, this);
+        friend constexpr difference_type operator-(const zip_iterator<Containers...>& _iter, const zip_sentinel& _end)
+            requires counted {
+            return _iter.index() - _end.stored_end;
         }
 
-        iterator end() noexcept {
-            return iterator(finish, this);
+    private:
+        static constexpr end_type end_of(const zip_iterator<Containers...>& _end) {
+            if constexpr (counted)
+                return _end.index();
+            else
+                return _end.base();
         }
+    };
 
-        const_iterator end() const noexcept {
-            return const_iterator(finish, this);
-        }
+#endif
 
-        [[maybe_unused]] const_iterator cend() const noexcept {
-            return const_iterator(finish, this);
-        }
+    /**
+     * Python-like zip over any number of containers. Iteration stops at the end of the
+     * shortest one. zip keeps pointers to the containers, so they must outlive it.
+     *
+     * When every container knows its length, like vectors, lists and xranges, the common
+     * length is computed once at construction: size() is available and iteration runs on
+     * a single counter. Such a zip does not see containers resized after its construction.
+     */
+    template<class... Containers>
+    class zip {
+        static_assert(sizeof...(Containers) > 0, "zip needs at least one container");
 
-        friend class xrange_iterator<value_type>;
+    public:
+        typedef zip_iterator<Containers...> iterator;
+        typedef typename iterator::value_type value_type;
+        typedef typename iterator::reference reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+#if __cplusplus >= 202002L
+        typedef zip_sentinel<Containers...> sentinel;
+#endif
+    private:
+        static constexpr bool counted = iterator::counted;
+        static constexpr bool random_access = std::is_same_v<typename iterator::iterator_category,
+            std::random_access_iterator_tag>;
+
+        std::tuple<Containers*...> containers;
+        difference_type length;
+        // Where each container stops when the zip is counted and bidirectional, but not random access
+        typename iterator::iterator_tuple ends;
+    public:
+        constexpr explicit zip(Containers&... _containers) noexcept
+            : containers(&_containers...), length(common_length(_containers...)), ends(stops(length, _containers...)) {}
 
-        friend class xrange_iterator<const_value_type>;
+        constexpr iterator begin() const {
+            return std::apply([](auto*... _container) { return iterator(0, std::begin(*_container)...); }, containers);
+        }
 
-        friend bool operator== <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
+        constexpr iterator end() const {
+            if constexpr (random_access) {
+                // Every iterator stops at the common length
+                return begin() + length;
+            } else if constexpr (counted && std::is_same_v<typename iterator::iterator_category,
+                                     std::bidirectional_iterator_tag>) {
+                return std::apply([this](auto... _end) { return iterator(length, _end...); }, ends);
+            } else {
+                // Each container is walked to its own end, the shortest one stops the zip
+                return std::apply([this](auto*... _container) { return iterator(length, std::end(*_container)...); },
+                                  containers);
+            }
+        }
 
-        friend bool operator!= <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
+#if __cplusplus >= 202002L
+        // end() for loops and std::ranges::subrange that only need to know where to stop
+        constexpr sentinel end_sentinel() const {
+            return sentinel(end());
+        }
+#endif
 
-        friend bool operator< <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
+        template<bool Counted = counted, typename = std::enable_if_t<Counted>>
+        constexpr size_type size() const noexcept {
+            return static_cast<size_type>(length);
+        }
 
-        friend bool operator> <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
+        template<bool Counted = counted, typename = std::enable_if_t<Counted>>
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return length == 0;
+        }
 
-        friend bool operator<= <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
+        template<bool RandomAccess = random_access, typename = std::enable_if_t<RandomAccess>>
+        constexpr reference operator[](size_type _index) const {
+            return begin()[static_cast<difference_type>(_index)];
+        }
 
-        friend bool operator>= <value_type>(const xrange_iterator<value_type>& _l, const xrange_iterator<value_type>& _r);
-    };
+    private:
+        static constexpr difference_type common_length(Containers&... _containers) {
+            if constexpr (counted)
+                return std::min({detail::container_length(_containers)...});
+            else
+                return 0; // Not known, the iterators of the zip compare their ends instead
+        }
 
-    template<typename T>
-    bool operator==(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) {
-        if (_l.stored_value >= _l.stored_xrange->finish && _r.stored_value >= _r.stored_xrange->finish)
-            return true;
+        // Stepping back from end() must reach the last common element, so longer containers stop early
+        static constexpr typename iterator::iterator_tuple stops(difference_type _length, Containers&... _containers) {
+            if constexpr (counted && std::is_same_v<typename iterator::iterator_category, std::bidirectional_iterator_tag>) {
+                return typename iterator::iterator_tuple((detail::container_length(_containers) == _length
+                    ? std::end(_containers) : std::next(std::begin(_containers), _length))...);
+            } else {
+                return typename iterator::iterator_tuple();
+            }
+        }
+    };
 
-        return _l.stored_value == _r.stored_value;
+    /**
+     * zip over containers that must have the same length, like Python's zip(strict=True)
+     *
+     * @throws std::invalid_argument if the containers differ in length
+     */
+    template<class... Containers>
+    constexpr zip<Containers...> zip_strict(Containers&... _containers) {
+        const std::ptrdiff_t lengths[] = {detail::container_length(_containers)...};
+        for (auto length : lengths)
+            if (length != lengths[0])
+                throw std::invalid_argument("zip_strict containers differ in length");
+
+        return zip<Containers...>(_containers...);
     }
 
-    template<typename T>
-    bool operator!=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) {
-        if (_l.stored_value >= _l.stored_xrange->finish && _r.stored_value >= _r.stored_xrange->finish)
-            return false;
+    // Counted zips compare positions. Other positions match when any of the iterators match,
+    // so the end of the shortest container ends the zip.
+
+    template<class... Containers>
+    constexpr bool operator==(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r) {
+        if constexpr (zip_iterator<Containers...>::counted) {
+            return _l.stored_index == _r.stored_index;
+        } else {
+            return std::apply([&_r](const auto&... _l_iter) {
+                return std::apply([&](const auto&... _r_iter) { return ((_l_iter == _r_iter) || ...); }, _r.iters);
+            }, _l.iters);
+        }
+    }
 
-        return _l.stored_value != _r.stored_value;
+    template<class... Containers>
+    constexpr bool operator!=(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r) {
+        return !(_l == _r);
     }
 
-    template<typename T>
-    bool operator<(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) {
-        return _l.stored_value < _r.stored_value;
+    template<class... Containers>
+    constexpr bool operator<(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r) {
+        return _l.stored_index < _r.stored_index;
     }
 
-    template<typename T>
-    bool operator>(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) {
-        return _l.stored_value > _r.stored_value;
+    template<class... Containers>
+    constexpr bool operator>(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r) {
+        return _l.stored_index > _r.stored_index;
     }
 
-    template<typename T>
-    bool operator<=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) {
-        if (_l.stored_value >= _l.stored_xrange->finish && _r.stored_value >= _r.stored_xrange->finish)
-            return true;
+    template<class... Containers>
+    constexpr bool operator<=(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r) {
+        return _l.stored_index <= _r.stored_index;
+    }
 
-        return _l.stored_value <= _r.stored_value;
+    template<class... Containers>
+    constexpr bool operator>=(const zip_iterator<Containers...>& _l, const zip_iterator<Containers...>& _r) {
+        return _l.stored_index >= _r.stored_index;
     }
 
-    template<typename T>
-    bool operator>=(const xrange_iterator<T>& _l, const xrange_iterator<T>& _r) {
-        if (_l.stored_value >= _l.stored_xrange->finish && _r.stored_value >= _r.stored_xrange->finish)
-            return true;
+    template<class... Containers>
+    class zip_longest;
 
-        return _l.stored_value >= _r.stored_value;
-    }
+    namespace detail {
 
-#endif
+        // Read-only element of a zip_longest column: a const reference when the container
+        // hands out references, its value otherwise
+        template<class Container>
+        using longest_reference_t = std::conditional_t<
+            std::is_lvalue_reference_v<typename std::iterator_traits<container_iterator_t<Container>>::reference>,
+            const typename std::iterator_traits<container_iterator_t<Container>>::value_type&,
+            typename std::iterator_traits<container_iterator_t<Container>>::value_type>;
 
-#if __cplusplus >= 201103L
+    } // namespace detail
 
-    // Declaring templates
+    /**
+     * Iterator of a zip_longest. Each container's iterator stops at its own end, and from
+     * there on the column yields its fill value.
+     */
+    template<class... Containers>
+    class zip_longest_iterator {
+    public:
+        typedef std::tuple<detail::container_iterator_t<Containers>...> iterator_tuple;
+        typedef std::tuple<typename std::iterator_traits<detail::container_iterator_t<Containers>>::value_type...> value_type;
+        typedef zip_reference<detail::longest_reference_t<Containers>...> reference;
+        typedef void pointer;
+        typedef std::ptrdiff_t difference_type;
+        [[maybe_unused]] typedef detail::common_iterator_category_t<detail::container_iterator_t<Containers>...> iterator_category;
 
-    template<class Container1, class Container2>
-    class zip;
+    private:
+        const zip_longest<Containers...>* parent;
+        iterator_tuple iters;
+        difference_type stored_index;
 
-    template<class Container1, class Container2>
-    class zip_iterator;
+    public:
+        constexpr explicit zip_longest_iterator() noexcept
+            : parent(), iters(), stored_index() {}
 
-    template<typename T, typename U>
-    bool operator==(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r);
+        constexpr explicit zip_longest_iterator(const zip_longest<Containers...>* _parent, difference_type _index,
+                                                detail::container_iterator_t<Containers>... _iters) noexcept
+            : parent(_parent), iters(_iters...), stored_index(_index) {}
+
+        constexpr const iterator_tuple& base() const noexcept {
+            return iters;
+        }
+
+        constexpr difference_type index() const noexcept {
+            return stored_index;
+        }
 
-    template<typename T, typename U>
-    bool operator!=(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r);
+        constexpr reference operator*() const {
+            return dereference(std::index_sequence_for<Containers...>());
+        }
 
-    template<typename T, typename U>
-    bool operator<(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r);
+        constexpr reference operator[](difference_type _n) const {
+            return *(*this + _n);
+        }
 
-    template<typename T, typename U>
-    bool operator>(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r);
+        constexpr zip_longest_iterator& operator++() {
+            advance(std::index_sequence_for<Containers...>());
+            ++stored_index;
 
-    template<typename T, typename U>
-    bool operator<=(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r);
+            return *this;
+        }
 
-    template<typename T, typename U>
-    bool operator>=(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r);
+        constexpr zip_longest_iterator operator++(int) {
+            auto old_iter = *this;
+            ++*this;
 
-    // Implementation
+            return old_iter;
+        }
 
-    template<class Container1, class Container2>
-    class zip_iterator {
-    public:
-        typedef Container1 first_container;
-        typedef Container2 second_container;
-        typedef typename first_container::const_iterator iterator_first_ctr;
-        typedef typename second_container::const_iterator iterator_second_ctr;
-        typedef const typename first_container::value_type value_type_first_ctr;
-        typedef const typename second_container::value_type value_type_second_ctr;
-        typedef std::pair<value_type_first_ctr, value_type_second_ctr> value_type;
-        typedef value_type* pointer;
-        [[maybe_unused]] typedef typename std::iterator_traits<pointer>::difference_type difference_type;
-        [[maybe_unused]] typedef std::input_iterator_tag iterator_category;
+        constexpr zip_longest_iterator& operator--() {
+            --stored_index;
+            retreat(std::index_sequence_for<Containers...>());
 
-    private:
-        const first_container* container1;
-        const second_container* container2;
-        iterator_first_ctr iter1;
-        iterator_second_ctr iter2;
+            return *this;
+        }
 
-    public:
-        explicit zip_iterator() noexcept
-            : container1(), container2(), iter1(), iter2() {}
+        constexpr zip_longest_iterator operator--(int) {
+            auto old_iter = *this;
+            --*this;
 
-        zip_iterator(const zip_iterator& _iter) noexcept
-            : container1(_iter.container1), container2(_iter.container2), iter1(_iter.iter1), iter2(_iter.iter2) {}
+            return old_iter;
+        }
 
-        zip_iterator& operator=(const zip_iterator& _iter) noexcept {
-            if (&_iter == this)
-                return *this;
-            container1 = _iter.container1;
-            container2 = _iter.container2;
-            iter1 = _iter.iter1;
-            iter2 = _iter.iter2;
+        constexpr zip_longest_iterator& operator+=(difference_type _n) {
+            jump(stored_index + _n, std::index_sequence_for<Containers...>());
+            stored_index += _n;
 
             return *this;
         }
 
-        explicit zip_iterator(const first_container& _container1,
-                              const second_container& _container2,
-                              iterator_first_ctr _iter1, iterator_second_ctr _iter2) noexcept {
+        constexpr zip_longest_iterator& operator-=(difference_type _n) {
+            return *this += -_n;
+        }
+
+        constexpr zip_longest_iterator operator+(difference_type _n) const {
+            auto iter = *this;
 
-            container1 = &_container1;
-            container2 = &_container2;
-            iter1 = _iter1;
-            iter2 = _iter2;
+            return iter += _n;
         }
 
-        value_type operator*() noexcept {
-            return std::make_pair(*iter1, *iter2);
+        friend constexpr zip_longest_iterator operator+(difference_type _n, const zip_longest_iterator& _iter) {
+            return _iter + _n;
         }
 
-        zip_iterator& operator++() noexcept {
-            if (iter1 < container1->end() &&
-                iter2 < container2->end()) {
-                iter1++;
-                iter2++;
-            }
+        constexpr zip_longest_iterator operator-(difference_type _n) const {
+            auto iter = *this;
 
-            return *this;
+            return iter -= _n;
         }
 
-        zip_iterator operator++(int) noexcept {
-            auto old_iter1 = iter1;
-            auto old_iter2 = iter2;
-            if (iter1 < container1->end() &&
-                iter2 < container2->end()) {
-                iter1++;
-                iter2++;
-            }
+        constexpr difference_type operator-(const zip_longest_iterator& _iter) const {
+            return stored_index - _iter.stored_index;
+        }
+
+        friend constexpr bool operator==(const zip_longest_iterator& _l, const zip_longest_iterator& _r) {
+            return _l.stored_index == _r.stored_index;
+        }
+
+        friend constexpr bool operator!=(const zip_longest_iterator& _l, const zip_longest_iterator& _r) {
+            return _l.stored_index != _r.stored_index;
+        }
+
+        friend constexpr bool operator<(const zip_longest_iterator& _l, const zip_longest_iterator& _r) {
+            return _l.stored_index < _r.stored_index;
+        }
 
-            return zip_iterator(*container1, *container2, old_iter1, old_iter2);
+        friend constexpr bool operator>(const zip_longest_iterator& _l, const zip_longest_iterator& _r) {
+            return _l.stored_index > _r.stored_index;
         }
 
-        friend bool operator== <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                   const zip_iterator<first_container, second_container>& _r);
+        friend constexpr bool operator<=(const zip_longest_iterator& _l, const zip_longest_iterator& _r) {
+            return _l.stored_index <= _r.stored_index;
+        }
 
-        friend bool operator!= <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                   const zip_iterator<first_container, second_container>& _r);
+        friend constexpr bool operator>=(const zip_longest_iterator& _l, const zip_longest_iterator& _r) {
+            return _l.stored_index >= _r.stored_index;
+        }
 
-        friend bool operator< <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                   const zip_iterator<first_container, second_container>& _r);
+    private:
+        template<std::size_t... I>
+        constexpr reference dereference(std::index_sequence<I...>) const {
+            return reference((stored_index < parent->lengths[I]
+                ? static_cast<std::tuple_element_t<I, reference>>(*std::get<I>(iters))
+                : static_cast<std::tuple_element_t<I, reference>>(std::get<I>(parent->fills)))...);
+        }
 
-        friend bool operator> <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                   const zip_iterator<first_container, second_container>& _r);
+        template<std::size_t... I>
+        constexpr void advance(std::index_sequence<I...>) {
+            ((stored_index < parent->lengths[I] ? static_cast<void>(++std::get<I>(iters)) : static_cast<void>(0)), ...);
+        }
 
-        friend bool operator<= <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                   const zip_iterator<first_container, second_container>& _r);
+        template<std::size_t... I>
+        constexpr void retreat(std::index_sequence<I...>) {
+            ((stored_index < parent->lengths[I] ? static_cast<void>(--std::get<I>(iters)) : static_cast<void>(0)), ...);
+        }
 
-        friend bool operator>= <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                   const zip_iterator<first_container, second_container>& _r);
+        // Moves each iterator by as much as it travels between the old and the new position
+        template<std::size_t... I>
+        constexpr void jump(difference_type _index, std::index_sequence<I...>) {
+            ((std::get<I>(iters) += std::min(_index, parent->lengths[I]) - std::min(stored_index, parent->lengths[I])), ...);
+        }
     };
 
-    template<class Container1, class Container2>
-    class zip {
+    /**
+     * Python-like zip_longest: iteration runs to the end of the longest container, and the
+     * columns of containers that ended earlier yield fill values, value-initialized unless
+     * set with with_fill(). Elements are read-only. Lengths are computed at construction,
+     * and zip_longest keeps pointers to the containers, so they must outlive it.
+     */
+    template<class... Containers>
+    class zip_longest {
+        static_assert(sizeof...(Containers) > 0, "zip_longest needs at least one container");
+
     public:
-        typedef Container1 first_container;
-        typedef Container2 second_container;
-        typedef typename first_container::value_type value_type_first_ctr;
-        typedef typename second_container::value_type value_type_second_ctr;
-        typedef std::pair<value_type_first_ctr, value_type_second_ctr> value_type;
-        [[maybe_unused]] typedef const value_type const_value_type;
-        typedef zip_iterator<first_container, second_container> iterator;
+        typedef zip_longest_iterator<Containers...> iterator;
+        typedef typename iterator::value_type value_type;
+        typedef typename iterator::reference reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
     private:
-        const first_container* container1;
-        const second_container* container2;
+        std::tuple<Containers*...> containers;
+        std::array<difference_type, sizeof...(Containers)> lengths;
+        value_type fills;
+        difference_type length;
+
+        friend class zip_longest_iterator<Containers...>;
+
     public:
-        explicit zip(const first_container& _container1, const second_container& _container2)
-            : container1(&_container1), container2(&_container2) {}
+        constexpr explicit zip_longest(Containers&... _containers)
+            : containers(&_containers...), lengths{detail::container_length(_containers)...}, fills(),
+              length(*std::max_element(lengths.begin(), lengths.end())) {}
+
+        /**
+         * Copy of this zip_longest with other fill values
+         *
+         * @param _fills One value per container
+         */
+        constexpr zip_longest with_fill(typename std::iterator_traits<detail::container_iterator_t<Containers>>::value_type... _fills) const {
+            auto filled = *this;
+            filled.fills = value_type(std::move(_fills)...);
+
+            return filled;
+        }
 
-        iterator begin() noexcept {
-            return iterator(*container1, *container2, container1->begin(), container2->begin());
+        constexpr iterator begin() const {
+            return std::apply([this](auto*... _container) { return iterator(this, 0, std::begin(*_container)...); },
+                              containers);
         }
 
-        iterator end() noexcept {
-            return iterator(*container1, *container2, container1->end(), container2->end());
+        // Every container is exhausted at the longest length, so each iterator is at its end
+        constexpr iterator end() const {
+            return std::apply([this](auto*... _container) { return iterator(this, length, std::end(*_container)...); },
+                              containers);
         }
 
-        friend class zip_iterator<first_container, second_container>;
+        constexpr size_type size() const noexcept {
+            return static_cast<size_type>(length);
+        }
 
-        friend bool operator== <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                   const zip_iterator<first_container, second_container>& _r);
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return length == 0;
+        }
+    };
 
-        friend bool operator!= <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                   const zip_iterator<first_container, second_container>& _r);
+    /**
+     * Indices that stably sort [first, last) by comp
+     *
+     * @tparam RandomIt Random access iterator
+     * @tparam Compare Type of comparator
+     * @return std::vector of positions in sorted order
+     */
+    template<
+        typename RandomIt,
+        typename = std::enable_if_t<std::is_base_of_v<std::random_access_iterator_tag,
+            typename std::iterator_traits<RandomIt>::iterator_category>>,
+        typename Compare = std::less<>>
+    std::vector<std::size_t> argsort(RandomIt first, RandomIt last, Compare comp = Compare()) {
+        std::vector<std::size_t> order(static_cast<std::size_t>(last - first));
+        std::iota(order.begin(), order.end(), std::size_t());
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t _l, std::size_t _r) {
+            return comp(first[_l], first[_r]);
+        });
+
+        return order;
+    }
 
-        friend bool operator< <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                  const zip_iterator<first_container, second_container>& _r);
+    namespace detail {
+
+        // Rearranges [first, first + order.size()) so that element i becomes first[order[i]]
+        template<typename RandomIt>
+        void apply_permutation(RandomIt first, const std::vector<std::size_t>& order, std::vector<bool>& placed) {
+            placed.assign(order.size(), false);
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                if (placed[i] || order[i] == i)
+                    continue;
+
+                auto saved = std::move(first[i]);
+                std::size_t hole = i;
+                for (std::size_t next = order[hole]; next != i; next = order[hole]) {
+                    first[hole] = std::move(first[next]);
+                    placed[hole] = true;
+                    hole = next;
+                }
+                first[hole] = std::move(saved);
+                placed[hole] = true;
+            }
+        }
 
-        friend bool operator> <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                  const zip_iterator<first_container, second_container>& _r);
+    } // namespace detail
 
-        friend bool operator<= <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                   const zip_iterator<first_container, second_container>& _r);
+    /**
+     * Stably sorts all columns of a random access zip by its first column. Unlike std::sort
+     * over the zip, which swaps every column on each exchange, it sorts an index permutation
+     * and then moves each element of each column once along the permutation cycles.
+     */
+    template<class... Containers, typename Compare = std::less<>>
+    void sort_by_key(const zip<Containers...>& _zip, Compare comp = Compare()) {
+        static_assert(std::is_same_v<typename zip_iterator<Containers...>::iterator_category, std::random_access_iterator_tag>,
+                      "sort_by_key needs random access containers");
+
+        auto first = _zip.begin();
+        auto last = _zip.end();
+        auto order = argsort(std::get<0>(first.base()), std::get<0>(last.base()), comp);
+        std::vector<bool> placed;
+        std::apply([&](auto... _iter) { (detail::apply_permutation(_iter, order, placed), ...); }, first.base());
+    }
 
-        friend bool operator>= <first_container, second_container>(const zip_iterator<first_container, second_container>& _l,
-                                                                   const zip_iterator<first_container, second_container>& _r);
+    /**
+     * Order in which zip_transform_reduce may combine values
+     */
+    enum class reduction_order {
+        // Any grouping: vector kernels and threads each keep their own partial results
+        relaxed,
+        // Fixed blocks of rows reduced one after another, so sequential and parallel calls on
+        // any number of threads return the same value, bit for bit for floating point sums
+        deterministic
     };
 
-    template<typename T, typename U>
-    bool operator==(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r) {
-        if ((_l.iter1 == _l.container1->end() ||
-             _l.iter2 == _l.container2->end()) &&
-            (_r.iter1 == _r.container1->end() ||
-             _l.iter2 == _l.container2->end()))
-            return true;
+    /**
+     * Left fold over the rows of a zip: init = op(init, row) for every row in order.
+     * Rows are zip_references, so no element is copied.
+     */
+    template<class... Containers, typename T, typename BinaryOp>
+    constexpr T zip_reduce(const zip<Containers...>& _zip, T init, BinaryOp op) {
+        for (auto last = _zip.end(), iter = _zip.begin(); iter != last; ++iter)
+            init = op(std::move(init), *iter);
 
-        return _l.iter1 == _r.iter1;
+        return init;
     }
 
-    template<typename T, typename U>
-    bool operator!=(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r) {
-        if ((_l.iter1 == _l.container1->end() ||
-             _l.iter2 == _l.container2->end()) &&
-            (_r.iter1 == _r.container1->end() ||
-             _l.iter2 == _l.container2->end()))
-            return false;
+    namespace detail {
+
+        // Rows per block of a deterministic reduction
+        inline constexpr std::size_t reduce_block = 1 << 14;
+
+        template<typename Function, template<typename> class Functor, typename T>
+        inline constexpr bool is_functor_v = std::is_same_v<Function, Functor<void>> || std::is_same_v<Function, Functor<T>>;
+
+        /**
+         * Vector kernel of a zip_transform_reduce, if any: a zip of two contiguous columns of the
+         * same arithmetic type reduced with std::plus, either of the products into a sum of the
+         * same floating point type, or of comparisons into an integral count.
+         */
+        template<typename T, typename Reduce, typename Transform, class... Containers>
+        struct zip_kernel {
+            static constexpr bool dot = false;
+            static constexpr bool count = false;
+        };
+
+#ifdef PY_ALGO_SIMD_DISPATCH
+        template<typename T, typename Reduce, typename Transform, class A, class B>
+        struct zip_kernel<T, Reduce, Transform, A, B> {
+            typedef std::remove_cv_t<typename std::iterator_traits<container_iterator_t<A>>::value_type> value_type;
+
+            static constexpr bool columns = simd::is_dispatchable_v<container_iterator_t<A>,
+                typename std::iterator_traits<container_iterator_t<B>>::value_type> &&
+                simd::is_dispatchable_v<container_iterator_t<B>, value_type> && is_functor_v<Reduce, std::plus, T>;
+
+            static constexpr bool dot = columns && std::is_floating_point_v<value_type> && std::is_same_v<T, value_type> &&
+                is_functor_v<Transform, std::multiplies, value_type>;
+
+            // >, >= count the swapped columns with <, <=
+            static constexpr bool swapped = is_functor_v<Transform, std::greater, value_type> ||
+                is_functor_v<Transform, std::greater_equal, value_type>;
+
+            static constexpr simd::pair_compare compare =
+                is_functor_v<Transform, std::equal_to, value_type> ? simd::pair_compare::equal
+                : is_functor_v<Transform, std::not_equal_to, value_type> ? simd::pair_compare::not_equal
+                : is_functor_v<Transform, std::less, value_type> || is_functor_v<Transform, std::greater, value_type>
+                  ? simd::pair_compare::less : simd::pair_compare::less_equal;
+
+            static constexpr bool count = columns && std::is_integral_v<T> && !std::is_same_v<T, bool> && (swapped ||
+                is_functor_v<Transform, std::equal_to, value_type> || is_functor_v<Transform, std::not_equal_to, value_type> ||
+                is_functor_v<Transform, std::less, value_type> || is_functor_v<Transform, std::less_equal, value_type>);
+        };
+#endif
 
-        return _l.iter1 != _r.iter1;
-    }
+        template<class... Containers, typename Transform>
+        constexpr decltype(auto) transform_row(const zip_iterator<Containers...>& _iter, Transform& transform) {
+            return std::apply([&transform](const auto&... _part) -> decltype(auto) { return transform(*_part...); },
+                              _iter.base());
+        }
 
-    template<typename T, typename U>
-    bool operator<(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r) {
-        return _l.iter1 < _r.iter1;
-    }
+        // Reduction of rows [first, first + _count), _count > 0, without an initial value
+        template<typename T, class... Containers, typename Reduce, typename Transform>
+        constexpr T transform_reduce_rows(zip_iterator<Containers...> first, std::size_t _count, Reduce& reduce,
+                                          Transform& transform) {
+#ifdef PY_ALGO_SIMD_DISPATCH
+            typedef zip_kernel<T, Reduce, Transform, Containers...> kernel;
+            if constexpr (kernel::dot || kernel::count) {
+                if (!std::is_constant_evaluated()) {
+                    auto a = std::to_address(std::get<0>(first.base()));
+                    auto b = std::to_address(std::get<1>(first.base()));
+                    if constexpr (kernel::dot)
+                        return simd::dot(a, b, _count);
+                    else if constexpr (kernel::swapped)
+                        return static_cast<T>(simd::count_pairs<kernel::compare>(b, a, _count));
+                    else
+                        return static_cast<T>(simd::count_pairs<kernel::compare>(a, b, _count));
+                }
+            }
+#endif
+            T partial = transform_row(first, transform);
+            for (++first; --_count != 0; ++first)
+                partial = reduce(std::move(partial), transform_row(first, transform));
 
-    template<typename T, typename U>
-    bool operator>(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r) {
-        return _l.iter1 > _r.iter1;
-    }
+            return partial;
+        }
 
-    template<typename T, typename U>
-    bool operator<=(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r) {
-        if ((_l.iter1 == _l.container1->end() ||
-             _l.iter2 == _l.container2->end()) &&
-            (_r.iter1 == _r.container1->end() ||
-             _l.iter2 == _l.container2->end()))
-            return true;
+    } // namespace detail
+
+    /**
+     * Reduces transform(column values...) of every row of a zip with reduce, starting from init.
+     * transform receives the elements of a row as separate arguments. A zip of two contiguous
+     * columns of one arithmetic type runs a vector kernel when reduce is std::plus and transform
+     * is std::multiplies (an inner product, summed in init's type, which must be the column type)
+     * or a comparison such as std::less (counting the rows that compare true into an integral init).
+     *
+     * @param _order relaxed lets the kernels regroup floating point sums, other calls fold the rows
+     * in order; deterministic reduces fixed blocks of a random access zip one after another,
+     * which the parallel overload matches on any number of threads
+     */
+    template<class... Containers, typename T, typename Reduce, typename Transform>
+    constexpr T zip_transform_reduce(const zip<Containers...>& _zip, T init, Reduce reduce, Transform transform,
+                                     reduction_order _order = reduction_order::relaxed) {
+        auto first = _zip.begin();
+        auto last = _zip.end();
+        if constexpr (std::is_same_v<typename zip_iterator<Containers...>::iterator_category,
+            std::random_access_iterator_tag>) {
+            auto size = static_cast<std::size_t>(last - first);
+            if (_order == reduction_order::deterministic) {
+                for (std::size_t offset = 0; offset < size; offset += detail::reduce_block) {
+                    init = reduce(std::move(init), detail::transform_reduce_rows<T>(
+                        first + static_cast<std::ptrdiff_t>(offset), std::min(detail::reduce_block, size - offset),
+                        reduce, transform));
+                }
+                return init;
+            }
+#ifdef PY_ALGO_SIMD_DISPATCH
+            typedef detail::zip_kernel<T, Reduce, Transform, Containers...> kernel;
+            if constexpr (kernel::dot || kernel::count) {
+                if (!std::is_constant_evaluated()) {
+                    if (size != 0)
+                        init = reduce(std::move(init), detail::transform_reduce_rows<T>(first, size, reduce, transform));
+                    return init;
+                }
+            }
+#endif
+        }
+        for (; first != last; ++first)
+            init = reduce(std::move(init), detail::transform_row(first, transform));
 
-        return _l.iter1 <= _r.iter1;
+        return init;
     }
 
-    template<typename T, typename U>
-    bool operator>=(const zip_iterator<T, U>& _l, const zip_iterator<T, U>& _r) {
-        if ((_l.iter1 == _l.container1->end() ||
-             _l.iter2 == _l.container2->end()) &&
-            (_r.iter1 == _r.container1->end() ||
-             _l.iter2 == _l.container2->end()))
-            return true;
+    /**
+     * Parallel zip_transform_reduce over a random access zip. Relaxed order reduces one part
+     * per task and combines the parts in order; deterministic order returns exactly what the
+     * sequential overload does with reduction_order::deterministic.
+     */
+    template<
+        typename ExecutionPolicy,
+        class... Containers,
+        typename T,
+        typename Reduce,
+        typename Transform,
+        typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    T zip_transform_reduce(ExecutionPolicy&& policy, const zip<Containers...>& _zip, T init, Reduce reduce,
+                           Transform transform, reduction_order _order = reduction_order::relaxed) {
+        if constexpr (detail::runs_parallel_v<ExecutionPolicy, zip_iterator<Containers...>>) {
+            auto& executor = detail::executor_of(policy);
+            auto first = _zip.begin();
+            auto size = _zip.size();
+            auto blocks = (size + detail::reduce_block - 1) / detail::reduce_block;
+            auto parts = _order == reduction_order::deterministic ? blocks : std::min(executor.concurrency() * 4, blocks);
+            if (parts > 1) {
+                std::vector<std::optional<T>> partials(parts);
+                executor.run(parts, [&](std::size_t i) {
+                    auto part_first = _order == reduction_order::deterministic ? i * detail::reduce_block : size * i / parts;
+                    auto part_last = _order == reduction_order::deterministic
+                                     ? std::min(size, part_first + detail::reduce_block) : size * (i + 1) / parts;
+                    partials[i].emplace(detail::transform_reduce_rows<T>(first + static_cast<std::ptrdiff_t>(part_first),
+                                                                         part_last - part_first, reduce, transform));
+                });
+                for (auto& partial: partials)
+                    init = reduce(std::move(init), std::move(*partial));
+                return init;
+            }
+        }
 
-        return _l.iter1 >= _r.iter1;
+        return py_algo::zip_transform_reduce(_zip, std::move(init), std::move(reduce), std::move(transform), _order);
     }
 
 #endif
 
 } // namespace py_algo
 
+#if __cplusplus >= 201703L
+
+// Lets structured bindings unpack a zip_reference like the tuple it derives from
+
+template<class... References>
+struct std::tuple_size<py_algo::zip_reference<References...>>
+    : std::integral_constant<std::size_t, sizeof...(References)> {};
+
+template<std::size_t I, class... References>
+struct std::tuple_element<I, py_algo::zip_reference<References...>>
+    : std::tuple_element<I, std::tuple<References...>> {};
+
+#endif
+
+#if __cplusplus >= 202002L && defined(__cpp_lib_ranges)
+
+// xrange and zip copy in O(1) and their iterators do not point into them, so both are borrowed
+// views: std::views adaptors take them by value, and iterators may outlive a temporary range
+
+template<typename T>
+inline constexpr bool std::ranges::enable_view<py_algo::xrange<T>> = true;
+
+template<typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<py_algo::xrange<T>> = true;
+
+template<class... Containers>
+inline constexpr bool std::ranges::enable_view<py_algo::zip<Containers...>> = true;
+
+template<class... Containers>
+inline constexpr bool std::ranges::enable_borrowed_range<py_algo::zip<Containers...>> = true;
+
+#endif
+
 #endif //PY_ALGO_H
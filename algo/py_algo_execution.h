@@ -0,0 +1,594 @@
+#ifndef PY_ALGO_EXECUTION_H
+#define PY_ALGO_EXECUTION_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace py_algo {
+#if __cplusplus >= 201703L
+
+    template<typename Executor>
+    class executor_policy;
+
+    namespace execution {
+
+        class sequenced_policy {};
+
+        /**
+         * Runs on thread_pool::instance() unless on() binds it to another executor:
+         * any object with concurrency() and run(tasks, fn) like thread_pool.
+         */
+        class parallel_policy {
+        public:
+            template<typename Executor>
+            executor_policy<Executor> on(Executor& _executor) const noexcept {
+                return executor_policy<Executor>(_executor);
+            }
+        };
+
+        class parallel_unsequenced_policy : public parallel_policy {};
+
+        inline constexpr sequenced_policy seq{};
+        inline constexpr parallel_policy par{};
+        inline constexpr parallel_unsequenced_policy par_unseq{};
+
+    } // namespace execution
+
+    // Parallel policy bound to a caller-provided executor
+    template<typename Executor>
+    class executor_policy {
+    private:
+        Executor* stored_executor;
+
+    public:
+        explicit executor_policy(Executor& _executor) noexcept : stored_executor(&_executor) {}
+
+        Executor& executor() const noexcept {
+            return *stored_executor;
+        }
+    };
+
+    template<typename T>
+    struct is_execution_policy : std::false_type {};
+
+    template<>
+    struct is_execution_policy<execution::sequenced_policy> : std::true_type {};
+
+    template<>
+    struct is_execution_policy<execution::parallel_policy> : std::true_type {};
+
+    template<>
+    struct is_execution_policy<execution::parallel_unsequenced_policy> : std::true_type {};
+
+    template<typename Executor>
+    struct is_execution_policy<executor_policy<Executor>> : std::true_type {};
+
+    template<typename T>
+    inline constexpr bool is_execution_policy_v = is_execution_policy<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+
+    /**
+     * Cooperative cancellation flag. Tasks of a run() that have not started once it is
+     * cancelled are skipped; running tasks are expected to poll cancelled() themselves.
+     */
+    class cancellation_token {
+    private:
+        std::atomic<bool> stored_cancelled{false};
+
+    public:
+        cancellation_token() = default;
+
+        cancellation_token(const cancellation_token&) = delete;
+
+        cancellation_token& operator=(const cancellation_token&) = delete;
+
+        void cancel() noexcept {
+            stored_cancelled.store(true, std::memory_order_relaxed);
+        }
+
+        bool cancelled() const noexcept {
+            return stored_cancelled.load(std::memory_order_relaxed);
+        }
+    };
+
+    namespace detail {
+
+        /**
+         * Chase-Lev work-stealing deque of pointers. The owning thread pushes and pops at the
+         * bottom, any other thread steals from the top with a single CAS. The ring doubles when
+         * full; replaced rings live as long as the deque because a thief may still read one.
+         */
+        template<typename T>
+        class work_stealing_deque {
+        private:
+            struct ring {
+                std::int64_t capacity;
+                std::unique_ptr<std::atomic<T*>[]> slots;
+
+                explicit ring(std::int64_t _capacity)
+                    : capacity(_capacity), slots(new std::atomic<T*>[static_cast<std::size_t>(_capacity)]) {}
+
+                T* get(std::int64_t _index) const noexcept {
+                    return slots[static_cast<std::size_t>(_index & (capacity - 1))].load(std::memory_order_acquire);
+                }
+
+                void put(std::int64_t _index, T* _item) noexcept {
+                    slots[static_cast<std::size_t>(_index & (capacity - 1))].store(_item, std::memory_order_release);
+                }
+            };
+
+            std::atomic<std::int64_t> top{0};
+            std::atomic<std::int64_t> bottom{0};
+            std::atomic<ring*> buffer;
+            std::vector<std::unique_ptr<ring>> rings;
+
+        public:
+            explicit work_stealing_deque(std::int64_t _capacity = 64) {
+                rings.emplace_back(new ring(_capacity));
+                buffer.store(rings.back().get(), std::memory_order_relaxed);
+            }
+
+            work_stealing_deque(const work_stealing_deque&) = delete;
+
+            work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+            // Owner only
+            void push(T* _item) {
+                auto b = bottom.load(std::memory_order_relaxed);
+                auto t = top.load(std::memory_order_acquire);
+                auto* a = buffer.load(std::memory_order_relaxed);
+                if (b - t > a->capacity - 1) {
+                    rings.emplace_back(new ring(a->capacity * 2));
+                    auto* grown = rings.back().get();
+                    for (auto i = t; i < b; ++i)
+                        grown->put(i, a->get(i));
+                    buffer.store(grown, std::memory_order_release);
+                    a = grown;
+                }
+                a->put(b, _item);
+                bottom.store(b + 1, std::memory_order_release);
+            }
+
+            // Owner only; nullptr when empty
+            T* pop() noexcept {
+                auto b = bottom.load(std::memory_order_relaxed) - 1;
+                auto* a = buffer.load(std::memory_order_relaxed);
+                bottom.store(b, std::memory_order_seq_cst);
+                auto t = top.load(std::memory_order_seq_cst);
+                if (t > b) {
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                T* item = a->get(b);
+                if (t == b) {
+                    // Last element: race the thieves for it
+                    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                        item = nullptr;
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                }
+                return item;
+            }
+
+            // Any thread; nullptr when empty or when another thread won the race
+            T* steal() noexcept {
+                auto t = top.load(std::memory_order_seq_cst);
+                auto b = bottom.load(std::memory_order_seq_cst);
+                if (t >= b)
+                    return nullptr;
+
+                T* item = buffer.load(std::memory_order_acquire)->get(t);
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    return nullptr;
+                return item;
+            }
+        };
+
+        // Pool and worker the current thread belongs to, both null outside any pool
+        struct worker_binding {
+            const void* pool;
+            void* worker;
+        };
+
+        inline worker_binding& current_worker_binding() noexcept {
+            thread_local worker_binding binding{nullptr, nullptr};
+            return binding;
+        }
+
+    } // namespace detail
+
+    /**
+     * Work-stealing fork-join thread pool. Every worker owns a Chase-Lev deque: a task keeps
+     * splitting its index range in halves and pushes the right half, so idle threads steal
+     * the largest pieces. The calling thread takes part in every run(), so nested parallel
+     * calls never deadlock waiting for busy workers.
+     */
+    class thread_pool {
+    private:
+        struct run_state {
+            void* fn;
+            void (*invoke)(void*, std::size_t);
+            const cancellation_token* token;
+            std::atomic<std::size_t> remaining;
+            std::mutex error_mutex;
+            std::exception_ptr error;
+        };
+
+        struct task {
+            run_state* state;
+            std::size_t first;
+            std::size_t last;
+        };
+
+        struct worker {
+            detail::work_stealing_deque<task> tasks;
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<worker>> workers;
+        // Tasks split off by threads outside the pool
+        std::deque<task*> injected;
+        std::mutex injected_mutex;
+        // Upper bound of queued tasks; workers go to sleep only when it is zero
+        std::atomic<std::size_t> pending{0};
+        std::atomic<std::size_t> sleeping{0};
+        std::mutex sleep_mutex;
+        std::condition_variable wakeup;
+        bool stopping{false};
+        // Callers of run() sleep here once they find nothing to help with. It belongs to the pool
+        // rather than a run_state, which its caller may free as soon as the last task is counted.
+        std::mutex done_mutex;
+        std::condition_variable done;
+
+        // Failed looks for work a run() caller makes before it sleeps
+        static constexpr unsigned idle_spins = 64;
+
+    public:
+        /**
+         * @param _workers Background threads; the thread calling run() always helps as well
+         * @param _pin_threads Pin worker i to CPU i + 1, leaving CPU 0 to the caller (Linux only)
+         */
+        explicit thread_pool(std::size_t _workers, bool _pin_threads = false) {
+            workers.reserve(_workers);
+            for (std::size_t i = 0; i < _workers; ++i)
+                workers.emplace_back(new worker());
+            for (std::size_t i = 0; i < _workers; ++i) {
+                workers[i]->thread = std::thread([this, i] { worker_loop(*workers[i]); });
+                if (_pin_threads)
+                    pin(workers[i]->thread, i + 1);
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                stopping = true;
+            }
+            wakeup.notify_all();
+            for (auto& w: workers)
+                w->thread.join();
+        }
+
+        /**
+         * Pool behind the parallel overloads: hardware_concurrency() threads in total,
+         * or as many as the PY_ALGO_THREADS environment variable asks for.
+         */
+        static thread_pool& instance() {
+            static thread_pool pool(default_workers());
+            return pool;
+        }
+
+        // Threads that execute tasks of a run(), including the caller
+        std::size_t concurrency() const noexcept {
+            return workers.size() + 1;
+        }
+
+        /**
+         * Calls _fn(i) for every i in [0, _tasks) and returns once all of them finished.
+         * The first exception thrown by a task is rethrown in the caller.
+         */
+        template<typename Function>
+        void run(std::size_t _tasks, Function&& _fn) {
+            run_tasks(_tasks, _fn, nullptr);
+        }
+
+        // Same as run(), but tasks not yet started when _token is cancelled are skipped
+        template<typename Function>
+        void run(std::size_t _tasks, Function&& _fn, const cancellation_token& _token) {
+            run_tasks(_tasks, _fn, &_token);
+        }
+
+    private:
+        static std::size_t default_workers() {
+            if (const char* threads = std::getenv("PY_ALGO_THREADS")) {
+                auto value = std::strtoul(threads, nullptr, 10);
+                if (value > 0)
+                    return static_cast<std::size_t>(value) - 1;
+            }
+            return std::max(1u, std::thread::hardware_concurrency()) - 1;
+        }
+
+        static void pin([[maybe_unused]] std::thread& _thread, [[maybe_unused]] std::size_t _cpu) {
+#if defined(__linux__)
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(_cpu % std::max(1u, std::thread::hardware_concurrency()), &cpus);
+            pthread_setaffinity_np(_thread.native_handle(), sizeof(cpus), &cpus);
+#endif
+        }
+
+        worker* current_worker() const noexcept {
+            auto& binding = detail::current_worker_binding();
+            return binding.pool == this ? static_cast<worker*>(binding.worker) : nullptr;
+        }
+
+        template<typename Function>
+        void run_tasks(std::size_t _tasks, Function& _fn, const cancellation_token* _token) {
+            if (_tasks == 0)
+                return;
+            if (_tasks == 1 || workers.empty()) {
+                for (std::size_t i = 0; i < _tasks && !(_token && _token->cancelled()); ++i)
+                    _fn(i);
+                return;
+            }
+
+            run_state state{&_fn, [](void* _f, std::size_t i) { (*static_cast<Function*>(_f))(i); }, _token, {_tasks}, {}, {}};
+            execute(new task{&state, 0, _tasks});
+            // Help with whatever is queued until the tasks stolen from this run are done, and
+            // sleep once nothing is left to help with rather than spin through a long task
+            for (unsigned idle = 0; state.remaining.load(std::memory_order_acquire) != 0;) {
+                if (task* next = find_task()) {
+                    execute(next);
+                    idle = 0;
+                } else if (++idle < idle_spins) {
+                    std::this_thread::yield();
+                } else {
+                    std::unique_lock<std::mutex> lock(done_mutex);
+                    done.wait(lock, [&state] { return state.remaining.load(std::memory_order_acquire) == 0; });
+                }
+            }
+            if (state.error)
+                std::rethrow_exception(state.error);
+        }
+
+        // Hands out the upper halves of _task to other threads and runs its first index
+        void execute(task* _task) {
+            auto* state = _task->state;
+            auto first = _task->first, last = _task->last;
+            delete _task;
+            if (state->token && state->token->cancelled()) {
+                finish(state, last - first);
+                return;
+            }
+
+            while (last - first > 1) {
+                auto middle = first + (last - first) / 2;
+                submit(new task{state, middle, last});
+                last = middle;
+            }
+            try {
+                state->invoke(state->fn, first);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->error_mutex);
+                if (!state->error)
+                    state->error = std::current_exception();
+            }
+            finish(state, 1);
+        }
+
+        // Counts _count indices of _state as done; whoever counts the last one wakes the callers
+        void finish(run_state* _state, std::size_t _count) {
+            if (_state->remaining.fetch_sub(_count, std::memory_order_acq_rel) == _count) {
+                // _state may be freed from here on
+                std::lock_guard<std::mutex> lock(done_mutex);
+                done.notify_all();
+            }
+        }
+
+        void submit(task* _task) {
+            pending.fetch_add(1, std::memory_order_seq_cst);
+            if (worker* self = current_worker()) {
+                self->tasks.push(_task);
+            } else {
+                std::lock_guard<std::mutex> lock(injected_mutex);
+                injected.push_back(_task);
+            }
+            if (sleeping.load(std::memory_order_seq_cst) != 0) {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                wakeup.notify_one();
+            }
+        }
+
+        // Own deque first, then tasks injected from outside, then steal from the other workers
+        task* find_task() {
+            worker* self = current_worker();
+            task* found = self ? self->tasks.pop() : nullptr;
+            if (!found) {
+                std::lock_guard<std::mutex> lock(injected_mutex);
+                if (!injected.empty()) {
+                    found = injected.front();
+                    injected.pop_front();
+                }
+            }
+            for (std::size_t i = 0; !found && i < workers.size(); ++i) {
+                if (workers[i].get() != self)
+                    found = workers[i]->tasks.steal();
+            }
+            if (found)
+                pending.fetch_sub(1, std::memory_order_relaxed);
+            return found;
+        }
+
+        void worker_loop(worker& _self) {
+            detail::current_worker_binding() = {this, &_self};
+            for (;;) {
+                if (task* next = find_task()) {
+                    execute(next);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(sleep_mutex);
+                sleeping.fetch_add(1, std::memory_order_seq_cst);
+                wakeup.wait(lock, [this] { return stopping || pending.load(std::memory_order_seq_cst) != 0; });
+                sleeping.fetch_sub(1, std::memory_order_relaxed);
+                if (stopping)
+                    return;
+            }
+        }
+    };
+
+    namespace detail {
+
+        // Number of elements a chunk worker scans between two looks at the cancellation flag
+        inline constexpr std::size_t cancel_block = 1024;
+
+        // Smallest chunk worth handing to another thread
+        inline constexpr std::size_t default_grain = 1 << 14;
+
+        template<typename T>
+        void atomic_min(std::atomic<T>& _target, T _value) noexcept {
+            auto current = _target.load(std::memory_order_relaxed);
+            while (_value < current && !_target.compare_exchange_weak(current, _value, std::memory_order_relaxed)) {}
+        }
+
+        template<typename T>
+        void atomic_max(std::atomic<T>& _target, T _value) noexcept {
+            auto current = _target.load(std::memory_order_relaxed);
+            while (current < _value && !_target.compare_exchange_weak(current, _value, std::memory_order_relaxed)) {}
+        }
+
+        template<typename Iterator>
+        inline constexpr bool is_random_access_v = std::is_base_of_v<std::random_access_iterator_tag,
+            typename std::iterator_traits<Iterator>::iterator_category>;
+
+        template<typename ExecutionPolicy, typename Iterator>
+        inline constexpr bool runs_parallel_v = is_random_access_v<Iterator> &&
+            !std::is_same_v<std::remove_cv_t<std::remove_reference_t<ExecutionPolicy>>, execution::sequenced_policy>;
+
+        // Executor a parallel policy runs on
+        template<typename ExecutionPolicy>
+        thread_pool& executor_of(const ExecutionPolicy&) {
+            return thread_pool::instance();
+        }
+
+        template<typename Executor>
+        Executor& executor_of(const executor_policy<Executor>& _policy) {
+            return _policy.executor();
+        }
+
+        template<typename Executor, typename Function, typename = void>
+        inline constexpr bool runs_cancellable_v = false;
+
+        template<typename Executor, typename Function>
+        inline constexpr bool runs_cancellable_v<Executor, Function, std::void_t<decltype(std::declval<Executor&>().run(
+            std::size_t(), std::declval<Function&>(), std::declval<const cancellation_token&>()))>> = true;
+
+        // Executor::run() that skips tasks once _token is cancelled, also on executors without token support
+        template<typename Executor, typename Function>
+        void run_cancellable(Executor& _executor, std::size_t _tasks, Function&& _fn, const cancellation_token& _token) {
+            if constexpr (runs_cancellable_v<Executor, Function>) {
+                _executor.run(_tasks, _fn, _token);
+            } else {
+                _executor.run(_tasks, [&](std::size_t i) {
+                    if (!_token.cancelled())
+                        _fn(i);
+                });
+            }
+        }
+
+        /**
+         * Splits [first, last) into contiguous chunks of at least _grain elements
+         * and calls _fn(chunk_first, chunk_last) for each of them on _executor.
+         * Chunks that have not started once _token is cancelled are skipped.
+         */
+        template<typename Executor, typename RandomIt, typename ChunkFunction>
+        void parallel_chunks(Executor& _executor, RandomIt first, RandomIt last, std::size_t _grain,
+                             const cancellation_token& _token, ChunkFunction&& _fn) {
+            auto size = static_cast<std::size_t>(last - first);
+            std::size_t chunks = std::min(_executor.concurrency() * 4, (size + _grain - 1) / std::max<std::size_t>(_grain, 1));
+            if (chunks <= 1) {
+                _fn(first, last);
+                return;
+            }
+
+            run_cancellable(_executor, chunks, [&](std::size_t i) {
+                auto chunk_first = first + static_cast<std::ptrdiff_t>(size * i / chunks);
+                auto chunk_last = first + static_cast<std::ptrdiff_t>(size * (i + 1) / chunks);
+                _fn(chunk_first, chunk_last);
+            }, _token);
+        }
+
+        template<typename Executor, typename RandomIt, typename ChunkFunction>
+        void parallel_chunks(Executor& _executor, RandomIt first, RandomIt last, std::size_t _grain, ChunkFunction&& _fn) {
+            cancellation_token never;
+            parallel_chunks(_executor, first, last, _grain, never, std::forward<ChunkFunction>(_fn));
+        }
+
+        // Parallel search for any element matching p; the first match found cancels all chunks
+        template<typename Executor, typename RandomIt, typename UnaryPredicate>
+        bool parallel_any(Executor& _executor, RandomIt first, RandomIt last, UnaryPredicate& p,
+                          std::size_t _grain = default_grain) {
+            cancellation_token found;
+            parallel_chunks(_executor, first, last, _grain, found, [&](RandomIt chunk_first, RandomIt chunk_last) {
+                while (chunk_first != chunk_last && !found.cancelled()) {
+                    auto block = std::min<std::ptrdiff_t>(cancel_block, chunk_last - chunk_first);
+                    for (auto block_last = chunk_first + block; chunk_first != block_last; ++chunk_first) {
+                        if (p(*chunk_first)) {
+                            found.cancel();
+                            return;
+                        }
+                    }
+                }
+            });
+
+            return found.cancelled();
+        }
+
+        // Parallel count of matches that cancels all chunks once _limit matches were seen
+        template<typename Executor, typename RandomIt, typename UnaryPredicate>
+        std::size_t parallel_count_up_to(Executor& _executor, RandomIt first, RandomIt last, UnaryPredicate& p,
+                                         std::size_t _limit, std::size_t _grain = default_grain) {
+            std::atomic<std::size_t> count{0};
+            cancellation_token reached;
+            parallel_chunks(_executor, first, last, _grain, reached, [&](RandomIt chunk_first, RandomIt chunk_last) {
+                while (chunk_first != chunk_last && !reached.cancelled()) {
+                    auto block = std::min<std::ptrdiff_t>(cancel_block, chunk_last - chunk_first);
+                    for (auto block_last = chunk_first + block; chunk_first != block_last; ++chunk_first) {
+                        if (p(*chunk_first) && count.fetch_add(1, std::memory_order_relaxed) + 1 >= _limit) {
+                            reached.cancel();
+                            return;
+                        }
+                    }
+                }
+            });
+
+            return std::min(count.load(), _limit);
+        }
+
+    } // namespace detail
+
+#endif
+} // namespace py_algo
+
+#endif //PY_ALGO_EXECUTION_H
@@ -0,0 +1,286 @@
+#ifndef PY_ALGO_INSTRUMENT_H
+#define PY_ALGO_INSTRUMENT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Instrumented algorithms record every call into call_registry::local() when PY_ALGO_INSTRUMENT
+// is defined (C++20 only). Without it the probes are empty and compile away. The macro must be
+// the same in every translation unit of a program.
+
+namespace py_algo {
+#if __cplusplus >= 201703L
+
+    // Code path an instrumented call took
+    enum class call_kernel {
+        scalar,
+        simd,
+        parallel
+    };
+
+#if __cplusplus >= 202002L
+
+    /**
+     * One instrumented algorithm call. Offsets and sizes are -1 where they are unknown,
+     * e.g. the size of a range of forward iterators that was not walked to its end.
+     */
+    struct call_record {
+        const char* algorithm;
+        call_kernel kernel;
+        std::ptrdiff_t size;
+        std::size_t visited;
+        std::size_t predicate_calls;
+        std::ptrdiff_t exit_position;
+        bool early_exit;
+        std::chrono::nanoseconds elapsed;
+    };
+
+    inline const char* to_string(call_kernel _kernel) noexcept {
+        switch (_kernel) {
+            case call_kernel::simd:
+                return "simd";
+            case call_kernel::parallel:
+                return "parallel";
+            default:
+                return "scalar";
+        }
+    }
+
+    /**
+     * Per-thread list of instrumented calls. Records past the limit are only counted,
+     * while the callback still sees every call.
+     */
+    class call_registry {
+    private:
+        std::vector<call_record> stored_records;
+        std::function<void(const call_record&)> stored_callback;
+        std::size_t stored_limit{4096};
+        std::size_t stored_dropped{0};
+
+    public:
+        static call_registry& local() {
+            thread_local call_registry registry;
+            return registry;
+        }
+
+        void record(const call_record& _record) {
+            if (stored_callback)
+                stored_callback(_record);
+            if (stored_records.size() < stored_limit)
+                stored_records.push_back(_record);
+            else
+                ++stored_dropped;
+        }
+
+        const std::vector<call_record>& records() const noexcept {
+            return stored_records;
+        }
+
+        // Calls that did not fit under the limit
+        std::size_t dropped() const noexcept {
+            return stored_dropped;
+        }
+
+        void set_limit(std::size_t _limit) noexcept {
+            stored_limit = _limit;
+        }
+
+        // Called for every record as it is made, e.g. to forward it to a metrics system
+        void set_callback(std::function<void(const call_record&)> _callback) {
+            stored_callback = std::move(_callback);
+        }
+
+        void clear() noexcept {
+            stored_records.clear();
+            stored_dropped = 0;
+        }
+
+        template<typename Function>
+        void dump(Function&& _fn) const {
+            for (const auto& record: stored_records)
+                _fn(record);
+        }
+
+        // Writes {"dropped": n, "calls": [...]} with one object per record
+        void dump_json(std::ostream& _out) const {
+            auto offset = [&_out](std::ptrdiff_t _value) -> std::ostream& {
+                return _value < 0 ? _out << "null" : _out << _value;
+            };
+
+            _out << "{\"dropped\": " << stored_dropped << ", \"calls\": [";
+            for (std::size_t i = 0; i < stored_records.size(); ++i) {
+                const auto& record = stored_records[i];
+                _out << (i == 0 ? "" : ", ") << "{\"algorithm\": \"" << record.algorithm
+                     << "\", \"kernel\": \"" << to_string(record.kernel) << "\", \"size\": ";
+                offset(record.size) << ", \"visited\": " << record.visited
+                                    << ", \"predicate_calls\": " << record.predicate_calls << ", \"exit_position\": ";
+                offset(record.exit_position) << ", \"early_exit\": " << (record.early_exit ? "true" : "false")
+                                             << ", \"elapsed_ns\": " << record.elapsed.count() << "}";
+            }
+            _out << "]}";
+        }
+
+        std::string to_json() const {
+            std::ostringstream out;
+            dump_json(out);
+            return out.str();
+        }
+    };
+
+#endif
+
+    namespace detail {
+
+        /**
+         * Probe of an algorithm that is not instrumented. Algorithms report through the same
+         * calls on both probes, so with this one every report is a no-op.
+         */
+        struct null_probe {
+            constexpr null_probe() noexcept = default;
+
+            template<typename Iterator>
+            constexpr null_probe(const char*, Iterator, Iterator) noexcept {}
+
+            constexpr void use(call_kernel) noexcept {}
+
+            constexpr void visit(std::size_t = 1) noexcept {}
+
+            void visit_concurrent(std::size_t) noexcept {}
+
+            constexpr void exit_at(std::ptrdiff_t) noexcept {}
+
+            constexpr void exit_here() noexcept {}
+
+            constexpr void exit_early() noexcept {}
+
+            template<typename Predicate>
+            constexpr Predicate& counted(Predicate& _p) noexcept {
+                return _p;
+            }
+
+            template<typename Predicate>
+            constexpr Predicate& counted_concurrent(Predicate& _p) noexcept {
+                return _p;
+            }
+        };
+
+#if __cplusplus >= 202002L
+
+        /**
+         * Probe that measures one call and hands it to call_registry::local() on destruction.
+         * Calls made during constant evaluation are not recorded.
+         */
+        class recording_probe {
+        private:
+            const char* stored_algorithm;
+            call_kernel stored_kernel{call_kernel::scalar};
+            std::ptrdiff_t stored_size;
+            std::size_t stored_visited{0};
+            std::size_t stored_calls{0};
+            std::ptrdiff_t stored_exit{-1};
+            bool stored_early_exit{false};
+            std::int64_t stored_start{0};
+
+            static std::int64_t now() noexcept {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+        public:
+            template<typename Iterator>
+            constexpr recording_probe(const char* _algorithm, Iterator first, Iterator last)
+                : stored_algorithm(_algorithm), stored_size(-1) {
+                if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                    typename std::iterator_traits<Iterator>::iterator_category>)
+                    stored_size = last - first;
+                if (!std::is_constant_evaluated())
+                    stored_start = now();
+            }
+
+            recording_probe(const recording_probe&) = delete;
+
+            recording_probe& operator=(const recording_probe&) = delete;
+
+            constexpr ~recording_probe() {
+                if (std::is_constant_evaluated())
+                    return;
+                // A range walked to its end has the size of what was read
+                auto size = stored_size >= 0 || stored_early_exit ? stored_size : static_cast<std::ptrdiff_t>(stored_visited);
+                call_registry::local().record({stored_algorithm, stored_kernel, size, stored_visited, stored_calls,
+                                               stored_exit, stored_early_exit, std::chrono::nanoseconds(now() - stored_start)});
+            }
+
+            constexpr void use(call_kernel _kernel) noexcept {
+                stored_kernel = _kernel;
+            }
+
+            constexpr void visit(std::size_t _count = 1) noexcept {
+                stored_visited += _count;
+            }
+
+            // visit() for elements read by several threads at once
+            void visit_concurrent(std::size_t _count) noexcept {
+                std::atomic_ref<std::size_t>(stored_visited).fetch_add(_count, std::memory_order_relaxed);
+            }
+
+            // The call stopped early with its answer at _offset
+            constexpr void exit_at(std::ptrdiff_t _offset) noexcept {
+                stored_exit = _offset;
+                stored_early_exit = true;
+            }
+
+            // The call stopped early at the element visited last
+            constexpr void exit_here() noexcept {
+                exit_at(static_cast<std::ptrdiff_t>(stored_visited) - 1);
+            }
+
+            // The call stopped early at a position it does not know, e.g. when chunks were cancelled
+            constexpr void exit_early() noexcept {
+                stored_early_exit = true;
+            }
+
+            // Wraps a predicate so every call counts as one visited element
+            template<typename Predicate>
+            constexpr auto counted(Predicate& _p) noexcept {
+                return [this, &_p](auto&& _value) -> bool {
+                    ++stored_visited;
+                    ++stored_calls;
+                    return _p(std::forward<decltype(_value)>(_value));
+                };
+            }
+
+            // Same as counted(), for predicates called from several threads at once
+            template<typename Predicate>
+            auto counted_concurrent(Predicate& _p) noexcept {
+                return [this, &_p](auto&& _value) -> bool {
+                    std::atomic_ref<std::size_t>(stored_visited).fetch_add(1, std::memory_order_relaxed);
+                    std::atomic_ref<std::size_t>(stored_calls).fetch_add(1, std::memory_order_relaxed);
+                    return _p(std::forward<decltype(_value)>(_value));
+                };
+            }
+        };
+
+#endif
+
+#if defined(PY_ALGO_INSTRUMENT) && __cplusplus >= 202002L
+        typedef recording_probe call_probe;
+#else
+        typedef null_probe call_probe;
+#endif
+
+    } // namespace detail
+
+#endif
+} // namespace py_algo
+
+#endif //PY_ALGO_INSTRUMENT_H
@@ -0,0 +1,197 @@
+#ifndef PY_ALGO_MMAP_H
+#define PY_ALGO_MMAP_H
+
+#include <cerrno>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if !__has_include(<sys/mman.h>)
+#error "py_algo_mmap.h needs POSIX mmap"
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace py_algo {
+#if __cplusplus >= 201703L
+
+    // Access pattern hints passed to madvise
+    enum class mmap_advice {
+        normal,
+        sequential,
+        random,
+        willneed
+    };
+
+    /**
+     * Read-only memory mapping of a binary file holding an array of T. Iterators are
+     * plain const T* into the page-aligned mapping, so every algorithm (including the
+     * SIMD and parallel paths) scans the file in place, and zip pairs several mapped
+     * columns without copying them.
+     *
+     * @tparam T Trivially copyable element type stored in the file
+     */
+    template<typename T>
+    class mmap_range {
+        static_assert(std::is_trivially_copyable_v<T>, "mmap_range needs a trivially copyable element type");
+
+    public:
+        typedef T value_type;
+        typedef const T& reference;
+        typedef const T& const_reference;
+        typedef const T* iterator;
+        typedef const T* const_iterator;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+    private:
+        const T* stored_data;
+        size_type stored_size;
+        size_type stored_bytes;
+
+    public:
+        /**
+         * Maps the whole file
+         *
+         * @param _path Path to the file
+         * @param _advice Expected access pattern
+         * @throw std::system_error if the file cannot be opened or mapped
+         * @throw std::invalid_argument if the file size is not a multiple of sizeof(T)
+         */
+        explicit mmap_range(const std::string& _path, mmap_advice _advice = mmap_advice::sequential)
+            : stored_data(nullptr), stored_size(0), stored_bytes(0) {
+            int fd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd == -1)
+                throw std::system_error(errno, std::generic_category(), "mmap_range: cannot open " + _path);
+
+            struct stat info{};
+            if (::fstat(fd, &info) == -1) {
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "mmap_range: cannot stat " + _path);
+            }
+            auto bytes = static_cast<size_type>(info.st_size);
+            if (bytes % sizeof(T) != 0) {
+                ::close(fd);
+                throw std::invalid_argument("mmap_range: size of " + _path + " is not a multiple of the element size");
+            }
+
+            // An empty file cannot be mapped and is kept as an empty range
+            if (bytes != 0) {
+                void* address = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address == MAP_FAILED) {
+                    int error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), "mmap_range: cannot map " + _path);
+                }
+                stored_data = static_cast<const T*>(address);
+                stored_size = bytes / sizeof(T);
+                stored_bytes = bytes;
+            }
+            ::close(fd);
+
+            advise(_advice);
+        }
+
+        mmap_range(const mmap_range&) = delete;
+
+        mmap_range& operator=(const mmap_range&) = delete;
+
+        mmap_range(mmap_range&& _other) noexcept
+            : stored_data(std::exchange(_other.stored_data, nullptr)),
+              stored_size(std::exchange(_other.stored_size, 0)),
+              stored_bytes(std::exchange(_other.stored_bytes, 0)) {}
+
+        mmap_range& operator=(mmap_range&& _other) noexcept {
+            if (this != &_other) {
+                unmap();
+                stored_data = std::exchange(_other.stored_data, nullptr);
+                stored_size = std::exchange(_other.stored_size, 0);
+                stored_bytes = std::exchange(_other.stored_bytes, 0);
+            }
+
+            return *this;
+        }
+
+        ~mmap_range() {
+            unmap();
+        }
+
+        /**
+         * Tells the kernel how the mapping is going to be read. Hints are advisory,
+         * so a failing madvise is ignored.
+         */
+        void advise(mmap_advice _advice) const noexcept {
+            if (stored_bytes == 0)
+                return;
+
+            int advice = MADV_NORMAL;
+            switch (_advice) {
+                case mmap_advice::normal:
+                    advice = MADV_NORMAL;
+                    break;
+                case mmap_advice::sequential:
+                    advice = MADV_SEQUENTIAL;
+                    break;
+                case mmap_advice::random:
+                    advice = MADV_RANDOM;
+                    break;
+                case mmap_advice::willneed:
+                    advice = MADV_WILLNEED;
+                    break;
+            }
+            ::madvise(const_cast<T*>(stored_data), stored_bytes, advice);
+        }
+
+        const T* data() const noexcept {
+            return stored_data;
+        }
+
+        iterator begin() const noexcept {
+            return stored_data;
+        }
+
+        iterator end() const noexcept {
+            return stored_data + stored_size;
+        }
+
+        const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept {
+            return end();
+        }
+
+        size_type size() const noexcept {
+            return stored_size;
+        }
+
+        bool empty() const noexcept {
+            return stored_size == 0;
+        }
+
+        const_reference operator[](size_type _n) const noexcept {
+            return stored_data[_n];
+        }
+
+    private:
+        void unmap() noexcept {
+            if (stored_data != nullptr)
+                ::munmap(const_cast<T*>(stored_data), stored_bytes);
+            stored_data = nullptr;
+            stored_size = 0;
+            stored_bytes = 0;
+        }
+    };
+
+#endif
+} // namespace py_algo
+
+#endif //PY_ALGO_MMAP_H
@@ -0,0 +1,396 @@
+#ifndef PY_ALGO_RANGES_H
+#define PY_ALGO_RANGES_H
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "py_algo.h"
+
+namespace py_algo {
+#if __cplusplus >= 202002L && defined(__cpp_lib_ranges)
+
+    // Range and iterator-sentinel overloads of the algorithms, constrained by std::ranges concepts:
+    //
+    //     py_algo::one_of(values, [](int x) { return x < 0; });
+    //     py_algo::is_sorted(py_algo::xrange<int>(0, 100, 3) | std::views::take(10));
+    //
+    // Ranges whose begin() and end() are iterators of one type with a strong enough
+    // iterator_category, like containers, xrange and zip, run the iterator-pair algorithms
+    // with their SIMD and xrange paths. So do random access iterators with a sized sentinel,
+    // once the end is computed from the distance. Other pairs, e.g. std::views ending in a
+    // sentinel or iterators with only a C++20 iterator_concept, run the plain loops here.
+    // Iterators returned for a temporary range that owns its elements are std::ranges::dangling.
+
+    namespace detail {
+
+        // Whether the iterator-pair overloads needing Tag accept [Iterator, Sentinel) as it is
+        template<class Iterator, class Sentinel, class Tag>
+        concept legacy_pair = std::same_as<Iterator, Sentinel> &&
+                              requires { typename std::iterator_traits<Iterator>::iterator_category; } &&
+                              std::is_base_of_v<Tag, typename std::iterator_traits<Iterator>::iterator_category>;
+
+        // Whether they accept it after the end is computed as first + (last - first)
+        template<class Iterator, class Sentinel, class Tag>
+        concept legacy_sized_pair = !std::same_as<Iterator, Sentinel> && std::random_access_iterator<Iterator> &&
+                                    std::sized_sentinel_for<Sentinel, Iterator> &&
+                                    legacy_pair<Iterator, Iterator, Tag>;
+
+        template<class Iterator, class Sentinel>
+        constexpr Iterator common_last(Iterator first, Sentinel last) {
+            return first + (last - first);
+        }
+
+        template<class Range, class Iterator>
+        constexpr std::ranges::borrowed_iterator_t<Range> borrowed(Iterator _iter) {
+            if constexpr (std::ranges::borrowed_range<Range>)
+                return _iter;
+            else
+                return std::ranges::dangling();
+        }
+
+        // Strings go to the std::string_view overloads, which leave out the terminating null of literals
+        template<class Range>
+        concept non_string_range = !std::is_convertible_v<Range, std::string_view>;
+
+    } // namespace detail
+
+    // Quantifiers
+
+    template<std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename UnaryPredicate>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::input_iterator_tag>)
+    constexpr bool all_of(Iterator first, Sentinel last, UnaryPredicate p) {
+        if constexpr (detail::legacy_sized_pair<Iterator, Sentinel, std::input_iterator_tag>) {
+            return py_algo::all_of(first, detail::common_last(first, last), p);
+        } else {
+            for (; first != last; ++first) {
+                if (!p(*first))
+                    return false;
+            }
+            return true;
+        }
+    }
+
+    template<std::ranges::input_range Range, typename UnaryPredicate>
+    constexpr bool all_of(Range&& _range, UnaryPredicate p) {
+        return py_algo::all_of(std::ranges::begin(_range), std::ranges::end(_range), p);
+    }
+
+    template<std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename UnaryPredicate>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::input_iterator_tag>)
+    constexpr bool any_of(Iterator first, Sentinel last, UnaryPredicate p) {
+        if constexpr (detail::legacy_sized_pair<Iterator, Sentinel, std::input_iterator_tag>) {
+            return py_algo::any_of(first, detail::common_last(first, last), p);
+        } else {
+            for (; first != last; ++first) {
+                if (p(*first))
+                    return true;
+            }
+            return false;
+        }
+    }
+
+    template<std::ranges::input_range Range, typename UnaryPredicate>
+    constexpr bool any_of(Range&& _range, UnaryPredicate p) {
+        return py_algo::any_of(std::ranges::begin(_range), std::ranges::end(_range), p);
+    }
+
+    template<std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename UnaryPredicate>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::input_iterator_tag>)
+    constexpr bool none_of(Iterator first, Sentinel last, UnaryPredicate p) {
+        return !py_algo::any_of(first, last, p);
+    }
+
+    template<std::ranges::input_range Range, typename UnaryPredicate>
+    constexpr bool none_of(Range&& _range, UnaryPredicate p) {
+        return py_algo::none_of(std::ranges::begin(_range), std::ranges::end(_range), p);
+    }
+
+    template<std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename UnaryPredicate>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::input_iterator_tag>)
+    constexpr bool one_of(Iterator first, Sentinel last, UnaryPredicate p) {
+        if constexpr (detail::legacy_sized_pair<Iterator, Sentinel, std::input_iterator_tag>) {
+            return py_algo::one_of(first, detail::common_last(first, last), p);
+        } else {
+            bool one_found = false;
+            for (; first != last; ++first) {
+                if (p(*first)) {
+                    if (one_found)
+                        return false;
+                    one_found = true;
+                }
+            }
+            return one_found;
+        }
+    }
+
+    template<std::ranges::input_range Range, typename UnaryPredicate>
+    constexpr bool one_of(Range&& _range, UnaryPredicate p) {
+        return py_algo::one_of(std::ranges::begin(_range), std::ranges::end(_range), p);
+    }
+
+    /**
+     * quantify() over an iterator and a sentinel. Matches it did not find are reported at
+     * the end of the range, which a scan that stops early finds by walking the rest.
+     */
+    template<std::forward_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename UnaryPredicate>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::forward_iterator_tag>)
+    constexpr quantifier_stats<Iterator> quantify(Iterator first, Sentinel last, UnaryPredicate p,
+                                                  quantifier requested = quantifier::everything) {
+        if constexpr (detail::legacy_sized_pair<Iterator, Sentinel, std::forward_iterator_tag>) {
+            return py_algo::quantify(first, detail::common_last(first, last), p, requested);
+        } else {
+            quantifier_stats<Iterator> stats{0, first, first, false};
+            for (; first != last; ++first) {
+                if (p(*first)) {
+                    if (stats.count++ == 0)
+                        stats.first_match = first;
+                    stats.last_match = first;
+                    if (stats.count <= 2 && detail::quantifiers_decided(requested, stats.count, stats.any_mismatch))
+                        break;
+                } else if (!stats.any_mismatch) {
+                    stats.any_mismatch = true;
+                    if (detail::quantifiers_decided(requested, stats.count, stats.any_mismatch))
+                        break;
+                }
+            }
+            if (stats.count == 0)
+                stats.first_match = stats.last_match = std::ranges::next(first, last);
+
+            return stats;
+        }
+    }
+
+    template<std::ranges::forward_range Range, typename UnaryPredicate>
+    constexpr quantifier_stats<std::ranges::borrowed_iterator_t<Range>> quantify(
+        Range&& _range, UnaryPredicate p, quantifier requested = quantifier::everything) {
+        auto stats = py_algo::quantify(std::ranges::begin(_range), std::ranges::end(_range), p, requested);
+        return {stats.count, detail::borrowed<Range>(stats.first_match), detail::borrowed<Range>(stats.last_match),
+                stats.any_mismatch};
+    }
+
+    // Sortedness
+
+    template<std::forward_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename Compare = std::less<>>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::forward_iterator_tag>)
+    constexpr Iterator is_sorted_until(Iterator first, Sentinel last, Compare comp = Compare()) {
+        if constexpr (detail::legacy_sized_pair<Iterator, Sentinel, std::forward_iterator_tag>) {
+            return py_algo::is_sorted_until(first, detail::common_last(first, last), comp);
+        } else {
+            if (first == last)
+                return first;
+            for (auto second = std::ranges::next(first); second != last; ++second, ++first) {
+                if (comp(*second, *first))
+                    return second;
+            }
+            return std::ranges::next(first);
+        }
+    }
+
+    template<std::ranges::forward_range Range, typename Compare = std::less<>>
+    constexpr std::ranges::borrowed_iterator_t<Range> is_sorted_until(Range&& _range, Compare comp = Compare()) {
+        return detail::borrowed<Range>(py_algo::is_sorted_until(std::ranges::begin(_range), std::ranges::end(_range), comp));
+    }
+
+    template<std::forward_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename Compare = std::less<>>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::forward_iterator_tag>)
+    constexpr bool is_sorted(Iterator first, Sentinel last, Compare comp = Compare()) {
+        return py_algo::is_sorted_until(first, last, comp) == last;
+    }
+
+    template<std::ranges::forward_range Range, typename Compare = std::less<>>
+    constexpr bool is_sorted(Range&& _range, Compare comp = Compare()) {
+        auto last = std::ranges::end(_range);
+        return py_algo::is_sorted_until(std::ranges::begin(_range), last, comp) == last;
+    }
+
+    template<std::forward_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename Compare = std::less<>>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::forward_iterator_tag>)
+    constexpr sortedness_stats<Iterator> sortedness(Iterator first, Sentinel last, Compare comp = Compare()) {
+        if constexpr (detail::legacy_sized_pair<Iterator, Sentinel, std::forward_iterator_tag>) {
+            return py_algo::sortedness(first, detail::common_last(first, last), comp);
+        } else {
+            sortedness_stats<Iterator> stats{first, 0, 0};
+            if (first == last)
+                return stats;
+
+            stats.first_violation = py_algo::is_sorted_until(first, last, comp);
+            if (stats.first_violation != last) {
+                auto previous = stats.first_violation;
+                stats.descents = 1;
+                for (auto current = std::ranges::next(previous); current != last; ++current, ++previous)
+                    stats.descents += comp(*current, *previous) ? 1 : 0;
+            }
+            stats.runs = stats.descents + 1;
+
+            return stats;
+        }
+    }
+
+    template<std::ranges::forward_range Range, typename Compare = std::less<>>
+    constexpr sortedness_stats<std::ranges::borrowed_iterator_t<Range>> sortedness(Range&& _range, Compare comp = Compare()) {
+        auto stats = py_algo::sortedness(std::ranges::begin(_range), std::ranges::end(_range), comp);
+        return {detail::borrowed<Range>(stats.first_violation), stats.descents, stats.runs};
+    }
+
+    // Partitions
+
+    template<std::forward_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename UnaryPredicate>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::forward_iterator_tag>)
+    constexpr partition_check<Iterator> is_partitioned_at(Iterator first, Sentinel last, UnaryPredicate p) {
+        if constexpr (detail::legacy_sized_pair<Iterator, Sentinel, std::forward_iterator_tag>) {
+            return py_algo::is_partitioned_at(first, detail::common_last(first, last), p);
+        } else {
+            for (; first != last && p(*first); ++first) {}
+
+            auto point = first;
+            for (; first != last; ++first) {
+                if (p(*first))
+                    return {false, point};
+            }
+            return {true, point};
+        }
+    }
+
+    template<std::ranges::forward_range Range, typename UnaryPredicate>
+    constexpr partition_check<std::ranges::borrowed_iterator_t<Range>> is_partitioned_at(Range&& _range, UnaryPredicate p) {
+        auto check = py_algo::is_partitioned_at(std::ranges::begin(_range), std::ranges::end(_range), p);
+        return {check.partitioned, detail::borrowed<Range>(check.partition_point)};
+    }
+
+    template<std::forward_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename UnaryPredicate>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::forward_iterator_tag>)
+    constexpr bool is_partitioned(Iterator first, Sentinel last, UnaryPredicate p) {
+        return py_algo::is_partitioned_at(first, last, p).partitioned;
+    }
+
+    template<std::ranges::forward_range Range, typename UnaryPredicate>
+    constexpr bool is_partitioned(Range&& _range, UnaryPredicate p) {
+        return py_algo::is_partitioned(std::ranges::begin(_range), std::ranges::end(_range), p);
+    }
+
+    // Searches
+
+    template<std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename T>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::input_iterator_tag>)
+    constexpr Iterator find_not(Iterator first, Sentinel last, const T& x) {
+        if constexpr (detail::legacy_sized_pair<Iterator, Sentinel, std::input_iterator_tag>) {
+            return py_algo::find_not(first, detail::common_last(first, last), x);
+        } else {
+            for (; first != last; ++first) {
+                if (*first != x)
+                    return first;
+            }
+            return first;
+        }
+    }
+
+    template<std::ranges::input_range Range, typename T>
+    constexpr std::ranges::borrowed_iterator_t<Range> find_not(Range&& _range, const T& x) {
+        return detail::borrowed<Range>(py_algo::find_not(std::ranges::begin(_range), std::ranges::end(_range), x));
+    }
+
+    /**
+     * find_backward() over an iterator and a sentinel. The scan walks forward to the end
+     * first unless the sentinel tells the distance.
+     */
+    template<std::bidirectional_iterator Iterator, std::sentinel_for<Iterator> Sentinel, typename T>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::bidirectional_iterator_tag>)
+    constexpr Iterator find_backward(Iterator first, Sentinel last, const T& x) {
+        if constexpr (detail::legacy_sized_pair<Iterator, Sentinel, std::bidirectional_iterator_tag>) {
+            return py_algo::find_backward(first, detail::common_last(first, last), x);
+        } else {
+            auto end = std::ranges::next(first, last);
+            for (auto current = end; current != first;) {
+                if (*--current == x)
+                    return current;
+            }
+            return end;
+        }
+    }
+
+    template<std::ranges::bidirectional_range Range, typename T>
+    constexpr std::ranges::borrowed_iterator_t<Range> find_backward(Range&& _range, const T& x) {
+        return detail::borrowed<Range>(py_algo::find_backward(std::ranges::begin(_range), std::ranges::end(_range), x));
+    }
+
+    template<std::ranges::input_range Range, std::ranges::forward_range Needles>
+    constexpr std::ranges::borrowed_iterator_t<Range> find_not_any_of(Range&& _range, Needles&& _needles) {
+        auto first = std::ranges::begin(_range);
+        auto last = std::ranges::end(_range);
+        auto s_first = std::ranges::begin(_needles);
+        auto s_last = std::ranges::end(_needles);
+        if constexpr (detail::legacy_pair<decltype(first), decltype(last), std::input_iterator_tag> &&
+                      detail::legacy_pair<decltype(s_first), decltype(s_last), std::forward_iterator_tag>) {
+            return detail::borrowed<Range>(py_algo::find_not_any_of(first, last, s_first, s_last));
+        } else {
+            for (; first != last; ++first) {
+                if (std::ranges::find(s_first, s_last, *first) == s_last)
+                    break;
+            }
+            return detail::borrowed<Range>(first);
+        }
+    }
+
+    template<std::ranges::input_range Range, typename T>
+    constexpr std::ranges::borrowed_iterator_t<Range> find_not_any_of(Range&& _range, std::initializer_list<T> needles) {
+        return py_algo::find_not_any_of(std::forward<Range>(_range), std::ranges::subrange(needles.begin(), needles.end()));
+    }
+
+    template<std::ranges::bidirectional_range Range, std::ranges::forward_range Needles>
+    constexpr std::ranges::borrowed_iterator_t<Range> find_backward_any_of(Range&& _range, Needles&& _needles) {
+        auto first = std::ranges::begin(_range);
+        auto last = std::ranges::end(_range);
+        auto s_first = std::ranges::begin(_needles);
+        auto s_last = std::ranges::end(_needles);
+        if constexpr (detail::legacy_pair<decltype(first), decltype(last), std::bidirectional_iterator_tag> &&
+                      detail::legacy_pair<decltype(s_first), decltype(s_last), std::forward_iterator_tag>) {
+            return detail::borrowed<Range>(py_algo::find_backward_any_of(first, last, s_first, s_last));
+        } else {
+            auto end = std::ranges::next(first, last);
+            for (auto current = end; current != first;) {
+                if (std::ranges::find(s_first, s_last, *--current) != s_last)
+                    return detail::borrowed<Range>(current);
+            }
+            return detail::borrowed<Range>(end);
+        }
+    }
+
+    template<std::ranges::bidirectional_range Range, typename T>
+    constexpr std::ranges::borrowed_iterator_t<Range> find_backward_any_of(Range&& _range, std::initializer_list<T> needles) {
+        return py_algo::find_backward_any_of(std::forward<Range>(_range), std::ranges::subrange(needles.begin(), needles.end()));
+    }
+
+    // Palindromes
+
+    template<std::bidirectional_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+        requires (!detail::legacy_pair<Iterator, Sentinel, std::bidirectional_iterator_tag>)
+    constexpr bool is_palindrome(Iterator first, Sentinel last) {
+        if constexpr (detail::legacy_sized_pair<Iterator, Sentinel, std::bidirectional_iterator_tag>) {
+            return py_algo::is_palindrome(first, detail::common_last(first, last));
+        } else {
+            auto end = std::ranges::next(first, last);
+            while (first != end && first != --end) {
+                if (*first != *end)
+                    return false;
+                ++first;
+            }
+            return true;
+        }
+    }
+
+    template<std::ranges::bidirectional_range Range>
+        requires detail::non_string_range<Range>
+    constexpr bool is_palindrome(Range&& _range) {
+        return py_algo::is_palindrome(std::ranges::begin(_range), std::ranges::end(_range));
+    }
+
+#endif
+} // namespace py_algo
+
+#endif //PY_ALGO_RANGES_H
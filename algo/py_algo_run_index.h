@@ -0,0 +1,262 @@
+#ifndef PY_ALGO_RUN_INDEX_H
+#define PY_ALGO_RUN_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <type_traits>
+#include <vector>
+
+#include "py_algo.h"
+
+namespace py_algo {
+#if __cplusplus >= 201703L
+
+    // Run-length index for repeated queries on one mostly constant buffer:
+    //
+    //     py_algo::run_index index(frame.begin(), frame.end());
+    //     auto sample = py_algo::find_not(index, frame.begin() + k, frame.end(), fill);
+    //     frame[i] = x;
+    //     index.update(frame.begin() + i);
+    //
+    // A run is a maximal block of equal elements. The index keeps the start and value of every
+    // run, and the starts of the runs of each value, so find_not and find_backward over any
+    // subrange take O(log runs) instead of scanning. Elements are compared with == and ordered
+    // with <, which must agree, so floating point buffers must not hold NaN.
+
+    /**
+     * Run boundaries of a random access range [first, last). The range must outlive the index,
+     * keep its size, and every write to it must be followed by update() of the written position.
+     * An index that would hold more than max_runs runs is saturated: it drops its tables and the
+     * queries scan the range like the plain algorithms, until rebuild() finds few enough runs.
+     */
+    template<typename RandomIt>
+    class run_index {
+        static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                          typename std::iterator_traits<RandomIt>::iterator_category>,
+                      "run_index needs random access iterators");
+
+    public:
+        typedef std::remove_cv_t<typename std::iterator_traits<RandomIt>::value_type> value_type;
+        typedef std::size_t size_type;
+
+        // Elements of the range per allowed run when no max_runs is given
+        static constexpr size_type default_density = 16;
+
+    private:
+        RandomIt stored_first;
+        size_type stored_size;
+        size_type stored_max_runs;
+        bool stored_saturated;
+        // Offset and value of every run, in order
+        std::vector<size_type> starts;
+        std::vector<value_type> values;
+        // Offsets of the runs of each value, in order
+        std::map<value_type, std::vector<size_type>> runs_of;
+
+    public:
+        /**
+         * Indexes [first, last) in one pass that jumps from run to run with find_not
+         *
+         * @param _max_runs most runs the index holds, or 0 for max(64, size / 16)
+         */
+        run_index(RandomIt first, RandomIt last, size_type _max_runs = 0)
+            : stored_first(first), stored_size(static_cast<size_type>(last - first)),
+              stored_max_runs(_max_runs != 0 ? _max_runs : std::max<size_type>(64, stored_size / default_density)),
+              stored_saturated(false) {
+            rebuild();
+        }
+
+        RandomIt begin() const noexcept {
+            return stored_first;
+        }
+
+        RandomIt end() const noexcept {
+            return stored_first + static_cast<std::ptrdiff_t>(stored_size);
+        }
+
+        // Number of runs, 0 when saturated
+        size_type runs() const noexcept {
+            return starts.size();
+        }
+
+        size_type max_runs() const noexcept {
+            return stored_max_runs;
+        }
+
+        bool saturated() const noexcept {
+            return stored_saturated;
+        }
+
+        /**
+         * Heap bytes held by the index: the run tables plus an estimate of the map nodes
+         */
+        size_type memory_usage() const noexcept {
+            // A std::map node holds its value and three links plus a color
+            constexpr size_type node = sizeof(typename decltype(runs_of)::value_type) + 4 * sizeof(void*);
+            size_type bytes = starts.capacity() * sizeof(size_type) + values.capacity() * sizeof(value_type) +
+                              runs_of.size() * node;
+            for (const auto& [value, offsets]: runs_of)
+                bytes += offsets.capacity() * sizeof(size_type);
+
+            return bytes;
+        }
+
+        /**
+         * Indexes the range again from scratch, e.g. after many writes or to leave saturation
+         */
+        void rebuild() {
+            clear();
+            stored_saturated = false;
+            auto last = end();
+            for (size_type offset = 0; offset < stored_size;) {
+                if (starts.size() == stored_max_runs) {
+                    saturate();
+                    return;
+                }
+                auto run_first = stored_first + static_cast<std::ptrdiff_t>(offset);
+                add_run(starts.size(), offset, *run_first);
+                offset = static_cast<size_type>(py_algo::find_not(run_first, last, *run_first) - stored_first);
+            }
+        }
+
+        /**
+         * Accounts for a write to *_pos. Only the boundaries before and after _pos can change,
+         * so at most three runs are replaced.
+         */
+        void update(RandomIt _pos) {
+            if (stored_saturated)
+                return;
+
+            auto p = static_cast<size_type>(_pos - stored_first);
+            // Runs covering p - 1, p and p + 1; the boundaries at their ends stay where they are
+            auto lo = run_at(p == 0 ? 0 : p - 1);
+            auto hi = run_at(std::min(p + 1, stored_size - 1));
+            auto window_first = starts[lo];
+            auto window_last = hi + 1 < starts.size() ? starts[hi + 1] : stored_size;
+            for (auto r = hi + 1; r-- > lo;)
+                remove_run(r);
+
+            auto r = lo;
+            add_run(r++, window_first, element(window_first));
+            if (p > window_first && !(element(p) == element(p - 1)))
+                add_run(r++, p, element(p));
+            if (p + 1 < window_last && !(element(p + 1) == element(p)))
+                add_run(r++, p + 1, element(p + 1));
+            if (starts.size() > stored_max_runs)
+                saturate();
+        }
+
+        /**
+         * find_not over [first, last), a subrange of the indexed range
+         */
+        RandomIt find_not(RandomIt first, RandomIt last, const value_type& x) const {
+            if (stored_saturated)
+                return py_algo::find_not(first, last, x);
+            if (first == last)
+                return last;
+
+            auto r = run_at(static_cast<size_type>(first - stored_first));
+            if (!(values[r] == x))
+                return first;
+            // Neighbouring runs differ, so the next run starts with an element other than x
+            if (r + 1 == starts.size())
+                return last;
+
+            return std::min(last, stored_first + static_cast<std::ptrdiff_t>(starts[r + 1]));
+        }
+
+        /**
+         * find_backward over [first, last), a subrange of the indexed range
+         */
+        RandomIt find_backward(RandomIt first, RandomIt last, const value_type& x) const {
+            if (stored_saturated)
+                return py_algo::find_backward(first, last, x);
+            if (first == last)
+                return last;
+
+            auto back = static_cast<size_type>(last - stored_first) - 1;
+            auto r = run_at(back);
+            if (values[r] == x)
+                return last - 1;
+
+            auto same = runs_of.find(x);
+            if (same == runs_of.end())
+                return last;
+            // Last run of x before run r ends where the run after it starts
+            auto before = std::lower_bound(same->second.begin(), same->second.end(), starts[r]);
+            if (before == same->second.begin())
+                return last;
+            auto run_last = stored_first + static_cast<std::ptrdiff_t>(starts[run_at(*std::prev(before)) + 1]);
+
+            return run_last - 1 < first ? last : run_last - 1;
+        }
+
+    private:
+        const value_type& element(size_type _offset) const {
+            return stored_first[static_cast<std::ptrdiff_t>(_offset)];
+        }
+
+        // Index of the run holding the element at _offset
+        size_type run_at(size_type _offset) const {
+            return static_cast<size_type>(std::upper_bound(starts.begin(), starts.end(), _offset) - starts.begin()) - 1;
+        }
+
+        void add_run(size_type _run, size_type _offset, const value_type& _value) {
+            starts.insert(starts.begin() + static_cast<std::ptrdiff_t>(_run), _offset);
+            values.insert(values.begin() + static_cast<std::ptrdiff_t>(_run), _value);
+            auto& offsets = runs_of[_value];
+            offsets.insert(std::upper_bound(offsets.begin(), offsets.end(), _offset), _offset);
+        }
+
+        void remove_run(size_type _run) {
+            auto same = runs_of.find(values[_run]);
+            auto& offsets = same->second;
+            offsets.erase(std::lower_bound(offsets.begin(), offsets.end(), starts[_run]));
+            if (offsets.empty())
+                runs_of.erase(same);
+            starts.erase(starts.begin() + static_cast<std::ptrdiff_t>(_run));
+            values.erase(values.begin() + static_cast<std::ptrdiff_t>(_run));
+        }
+
+        void clear() {
+            starts.clear();
+            values.clear();
+            runs_of.clear();
+        }
+
+        void saturate() {
+            clear();
+            starts.shrink_to_fit();
+            values.shrink_to_fit();
+            stored_saturated = true;
+        }
+    };
+
+    template<typename RandomIt>
+    run_index(RandomIt, RandomIt) -> run_index<RandomIt>;
+
+    template<typename RandomIt>
+    run_index(RandomIt, RandomIt, std::size_t) -> run_index<RandomIt>;
+
+    /**
+     * find_not answered from a run_index over a range containing [first, last)
+     */
+    template<typename RandomIt, typename T>
+    RandomIt find_not(const run_index<RandomIt>& _index, RandomIt first, RandomIt last, const T& x) {
+        return _index.find_not(first, last, x);
+    }
+
+    /**
+     * find_backward answered from a run_index over a range containing [first, last)
+     */
+    template<typename RandomIt, typename T>
+    RandomIt find_backward(const run_index<RandomIt>& _index, RandomIt first, RandomIt last, const T& x) {
+        return _index.find_backward(first, last, x);
+    }
+
+#endif
+} // namespace py_algo
+
+#endif //PY_ALGO_RUN_INDEX_H
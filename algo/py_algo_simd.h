@@ -0,0 +1,1391 @@
+#ifndef PY_ALGO_SIMD_H
+#define PY_ALGO_SIMD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <version>
+#endif
+
+// Vector kernels are compiled with per-function target attributes and picked at run time,
+// so the library needs no -m flags. Define PY_ALGO_NO_SIMD to always use the scalar loops.
+#if !defined(PY_ALGO_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define PY_ALGO_SIMD_X86 1
+#include <immintrin.h>
+#define PY_ALGO_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define PY_ALGO_TARGET_AVX2 __attribute__((target("avx2")))
+#define PY_ALGO_TARGET_FMA __attribute__((target("avx2,fma")))
+#endif
+
+// Dispatch needs to tell constant evaluation apart and to unwrap contiguous iterators
+#if defined(__cpp_lib_is_constant_evaluated) && defined(__cpp_lib_concepts)
+#define PY_ALGO_SIMD_DISPATCH 1
+#endif
+
+namespace py_algo {
+#if __cplusplus >= 201703L
+
+    namespace detail::simd {
+
+        enum class isa {
+            scalar,
+            sse42,
+            avx2
+        };
+
+        inline isa detected_isa() noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            static const isa value = [] {
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx2"))
+                    return isa::avx2;
+                if (__builtin_cpu_supports("sse4.2"))
+                    return isa::sse42;
+                return isa::scalar;
+            }();
+            return value;
+#else
+            return isa::scalar;
+#endif
+        }
+
+        // Fused multiply-add, which the inner product kernels use on top of avx2
+        inline bool has_fma() noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            static const bool value = [] {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("fma") != 0;
+            }();
+            return value;
+#else
+            return false;
+#endif
+        }
+
+        // Element types the kernels compare lane-wise with the same result as operator==
+        template<typename T>
+        inline constexpr bool is_vectorizable_v = (std::is_integral_v<T> || std::is_same_v<T, float> ||
+                                                   std::is_same_v<T, double>) &&
+                                                  !std::is_same_v<T, bool> &&
+                                                  (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+        template<typename Iterator>
+        constexpr bool is_contiguous_iterator() {
+#ifdef PY_ALGO_SIMD_DISPATCH
+            return std::contiguous_iterator<Iterator>;
+#else
+            return std::is_pointer_v<Iterator>;
+#endif
+        }
+
+        // True when an algorithm over [Iterator, Iterator) searching for a T may run a vector kernel
+        template<typename Iterator, typename T>
+        inline constexpr bool is_dispatchable_v = [] {
+#ifdef PY_ALGO_SIMD_DISPATCH
+            if constexpr (is_contiguous_iterator<Iterator>()) {
+                typedef std::remove_cv_t<typename std::iterator_traits<Iterator>::value_type> value_type;
+                return is_vectorizable_v<value_type> && std::is_same_v<value_type, std::remove_cv_t<T>>;
+            }
+#endif
+            return false;
+        }();
+
+        // True when a needle of type U may be converted to the element type T for a kernel: every
+        // T converts one to one to the type == compares them in, so a T equals the needle exactly
+        // when it equals the converted needle. Floating point needles on integer buffers stay scalar.
+        template<typename T, typename U>
+        inline constexpr bool is_narrowable_needle_v = std::is_arithmetic_v<U> &&
+                                                       (std::is_floating_point_v<T> || std::is_integral_v<U>);
+
+        // is_dispatchable_v for a needle of any type the kernels can search for once narrowed
+        template<typename Iterator, typename U>
+        inline constexpr bool is_needle_dispatchable_v = [] {
+#ifdef PY_ALGO_SIMD_DISPATCH
+            if constexpr (is_contiguous_iterator<Iterator>()) {
+                typedef std::remove_cv_t<typename std::iterator_traits<Iterator>::value_type> value_type;
+                return is_vectorizable_v<value_type> && is_narrowable_needle_v<value_type, std::remove_cv_t<U>>;
+            }
+#endif
+            return false;
+        }();
+
+        /**
+         * Converts the needle x to the element type T
+         *
+         * @return false if no T compares equal to x, e.g. 300 for bytes, 0.1 for float or NaN
+         */
+        template<typename T, typename U>
+        bool narrow_needle(const U& x, T& _needle) noexcept {
+            if constexpr (std::is_floating_point_v<U> && sizeof(T) < sizeof(U)) {
+                // Finite values beyond the range of T have no conversion
+                if (std::isfinite(x) && std::fabs(x) > static_cast<U>(std::numeric_limits<T>::max()))
+                    return false;
+            }
+            typedef std::common_type_t<T, U> common_type;
+            _needle = static_cast<T>(x);
+            return static_cast<common_type>(_needle) == static_cast<common_type>(x);
+        }
+
+        template<typename T>
+        const T* find_not_scalar(const T* first, const T* last, T x) noexcept {
+            for (; first != last; ++first) {
+                if (*first != x)
+                    return first;
+            }
+
+            return last;
+        }
+
+        template<typename T>
+        const T* find_backward_scalar(const T* first, const T* last, T x) noexcept {
+            for (auto p = last; p != first;) {
+                if (*--p == x)
+                    return p;
+            }
+
+            return last;
+        }
+
+        template<typename T>
+        const T* is_sorted_until_scalar(const T* first, const T* last) noexcept {
+            if (first == last)
+                return last;
+            for (auto second = first + 1; second != last; ++second, ++first) {
+                if (*second < *first)
+                    return second;
+            }
+
+            return last;
+        }
+
+        template<typename T>
+        std::size_t count_descents_scalar(const T* first, const T* last) noexcept {
+            std::size_t descents = 0;
+            if (first == last)
+                return descents;
+            for (auto second = first + 1; second != last; ++second, ++first)
+                descents += *second < *first;
+
+            return descents;
+        }
+
+        template<typename T>
+        bool mirrored_equal_scalar(const T* front, const T* back_end, std::size_t count) noexcept {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (front[i] != *(back_end - 1 - i))
+                    return false;
+            }
+
+            return true;
+        }
+
+#ifdef PY_ALGO_SIMD_X86
+
+        // Byte mask of lanes equal to x: every element sets sizeof(T) consecutive bits
+
+        template<typename T>
+        PY_ALGO_TARGET_SSE42 inline unsigned eq_mask_sse42(const T* p, T x) noexcept {
+            if constexpr (std::is_same_v<T, float>) {
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_castps_si128(
+                    _mm_cmpeq_ps(_mm_loadu_ps(p), _mm_set1_ps(x)))));
+            } else if constexpr (std::is_same_v<T, double>) {
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_castpd_si128(
+                    _mm_cmpeq_pd(_mm_loadu_pd(p), _mm_set1_pd(x)))));
+            } else {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                __m128i eq;
+                if constexpr (sizeof(T) == 1)
+                    eq = _mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(x)));
+                else if constexpr (sizeof(T) == 2)
+                    eq = _mm_cmpeq_epi16(v, _mm_set1_epi16(static_cast<short>(x)));
+                else if constexpr (sizeof(T) == 4)
+                    eq = _mm_cmpeq_epi32(v, _mm_set1_epi32(static_cast<int>(x)));
+                else
+                    eq = _mm_cmpeq_epi64(v, _mm_set1_epi64x(static_cast<long long>(x)));
+                return static_cast<unsigned>(_mm_movemask_epi8(eq));
+            }
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_AVX2 inline unsigned eq_mask_avx2(const T* p, T x) noexcept {
+            if constexpr (std::is_same_v<T, float>) {
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(
+                    _mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_set1_ps(x), _CMP_EQ_OQ))));
+            } else if constexpr (std::is_same_v<T, double>) {
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(
+                    _mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_set1_pd(x), _CMP_EQ_OQ))));
+            } else {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                __m256i eq;
+                if constexpr (sizeof(T) == 1)
+                    eq = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(static_cast<char>(x)));
+                else if constexpr (sizeof(T) == 2)
+                    eq = _mm256_cmpeq_epi16(v, _mm256_set1_epi16(static_cast<short>(x)));
+                else if constexpr (sizeof(T) == 4)
+                    eq = _mm256_cmpeq_epi32(v, _mm256_set1_epi32(static_cast<int>(x)));
+                else
+                    eq = _mm256_cmpeq_epi64(v, _mm256_set1_epi64x(static_cast<long long>(x)));
+                return static_cast<unsigned>(_mm256_movemask_epi8(eq));
+            }
+        }
+
+        // Byte mask of lanes i where p[i + 1] < p[i]
+
+        template<typename T>
+        PY_ALGO_TARGET_SSE42 inline unsigned descent_mask_sse42(const T* p) noexcept {
+            if constexpr (std::is_same_v<T, float>) {
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_castps_si128(
+                    _mm_cmplt_ps(_mm_loadu_ps(p + 1), _mm_loadu_ps(p)))));
+            } else if constexpr (std::is_same_v<T, double>) {
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_castpd_si128(
+                    _mm_cmplt_pd(_mm_loadu_pd(p + 1), _mm_loadu_pd(p)))));
+            } else {
+                __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+                if constexpr (std::is_unsigned_v<T>) {
+                    // Flipping the sign bit maps unsigned order onto the signed compare
+                    __m128i bias;
+                    if constexpr (sizeof(T) == 1)
+                        bias = _mm_set1_epi8(static_cast<char>(0x80));
+                    else if constexpr (sizeof(T) == 2)
+                        bias = _mm_set1_epi16(static_cast<short>(0x8000));
+                    else if constexpr (sizeof(T) == 4)
+                        bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+                    else
+                        bias = _mm_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+                    current = _mm_xor_si128(current, bias);
+                    next = _mm_xor_si128(next, bias);
+                }
+                __m128i gt;
+                if constexpr (sizeof(T) == 1)
+                    gt = _mm_cmpgt_epi8(current, next);
+                else if constexpr (sizeof(T) == 2)
+                    gt = _mm_cmpgt_epi16(current, next);
+                else if constexpr (sizeof(T) == 4)
+                    gt = _mm_cmpgt_epi32(current, next);
+                else
+                    gt = _mm_cmpgt_epi64(current, next);
+                return static_cast<unsigned>(_mm_movemask_epi8(gt));
+            }
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_AVX2 inline unsigned descent_mask_avx2(const T* p) noexcept {
+            if constexpr (std::is_same_v<T, float>) {
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(
+                    _mm256_cmp_ps(_mm256_loadu_ps(p + 1), _mm256_loadu_ps(p), _CMP_LT_OQ))));
+            } else if constexpr (std::is_same_v<T, double>) {
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(
+                    _mm256_cmp_pd(_mm256_loadu_pd(p + 1), _mm256_loadu_pd(p), _CMP_LT_OQ))));
+            } else {
+                __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1));
+                if constexpr (std::is_unsigned_v<T>) {
+                    __m256i bias;
+                    if constexpr (sizeof(T) == 1)
+                        bias = _mm256_set1_epi8(static_cast<char>(0x80));
+                    else if constexpr (sizeof(T) == 2)
+                        bias = _mm256_set1_epi16(static_cast<short>(0x8000));
+                    else if constexpr (sizeof(T) == 4)
+                        bias = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+                    else
+                        bias = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+                    current = _mm256_xor_si256(current, bias);
+                    next = _mm256_xor_si256(next, bias);
+                }
+                __m256i gt;
+                if constexpr (sizeof(T) == 1)
+                    gt = _mm256_cmpgt_epi8(current, next);
+                else if constexpr (sizeof(T) == 2)
+                    gt = _mm256_cmpgt_epi16(current, next);
+                else if constexpr (sizeof(T) == 4)
+                    gt = _mm256_cmpgt_epi32(current, next);
+                else
+                    gt = _mm256_cmpgt_epi64(current, next);
+                return static_cast<unsigned>(_mm256_movemask_epi8(gt));
+            }
+        }
+
+        // Byte mask of lanes i where front[i] == back[lanes - 1 - i], reversing back with a lane shuffle
+
+        template<typename T>
+        PY_ALGO_TARGET_SSE42 inline unsigned mirror_mask_sse42(const T* front, const T* back) noexcept {
+            if constexpr (std::is_same_v<T, float>) {
+                __m128 reversed = _mm_shuffle_ps(_mm_loadu_ps(back), _mm_loadu_ps(back), 0x1B);
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_castps_si128(
+                    _mm_cmpeq_ps(_mm_loadu_ps(front), reversed))));
+            } else if constexpr (std::is_same_v<T, double>) {
+                __m128d reversed = _mm_shuffle_pd(_mm_loadu_pd(back), _mm_loadu_pd(back), 0x1);
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_castpd_si128(
+                    _mm_cmpeq_pd(_mm_loadu_pd(front), reversed))));
+            } else {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(back));
+                __m128i reversed;
+                if constexpr (sizeof(T) == 1)
+                    reversed = _mm_shuffle_epi8(v, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+                else if constexpr (sizeof(T) == 2)
+                    reversed = _mm_shuffle_epi8(v, _mm_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1));
+                else if constexpr (sizeof(T) == 4)
+                    reversed = _mm_shuffle_epi32(v, 0x1B);
+                else
+                    reversed = _mm_shuffle_epi32(v, 0x4E);
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(front)), reversed)));
+            }
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_AVX2 inline unsigned mirror_mask_avx2(const T* front, const T* back) noexcept {
+            if constexpr (std::is_same_v<T, float>) {
+                __m256 reversed = _mm256_permutevar8x32_ps(_mm256_loadu_ps(back), _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(
+                    _mm256_cmp_ps(_mm256_loadu_ps(front), reversed, _CMP_EQ_OQ))));
+            } else if constexpr (std::is_same_v<T, double>) {
+                __m256d reversed = _mm256_permute4x64_pd(_mm256_loadu_pd(back), 0x1B);
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(
+                    _mm256_cmp_pd(_mm256_loadu_pd(front), reversed, _CMP_EQ_OQ))));
+            } else {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(back));
+                __m256i reversed;
+                if constexpr (sizeof(T) == 1 || sizeof(T) == 2) {
+                    // Reverse inside each 128-bit half, then swap the halves
+                    __m256i pattern = sizeof(T) == 1
+                        ? _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                           15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+                        : _mm256_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+                                           14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+                    reversed = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, pattern), 0x4E);
+                } else if constexpr (sizeof(T) == 4) {
+                    reversed = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+                } else {
+                    reversed = _mm256_permute4x64_epi64(v, 0x1B);
+                }
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(front)), reversed)));
+            }
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_SSE42 bool mirrored_equal_sse42(const T* front, const T* back_end, std::size_t count) noexcept {
+            constexpr std::size_t lanes = 16 / sizeof(T);
+            for (; count >= lanes; count -= lanes, front += lanes) {
+                back_end -= lanes;
+                if (mirror_mask_sse42(front, back_end) != 0xFFFFu)
+                    return false;
+            }
+
+            return mirrored_equal_scalar(front, back_end, count);
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_AVX2 bool mirrored_equal_avx2(const T* front, const T* back_end, std::size_t count) noexcept {
+            constexpr std::size_t lanes = 32 / sizeof(T);
+            for (; count >= 2 * lanes; count -= 2 * lanes, front += 2 * lanes) {
+                back_end -= 2 * lanes;
+                if ((mirror_mask_avx2(front, back_end + lanes) & mirror_mask_avx2(front + lanes, back_end)) != 0xFFFFFFFFu)
+                    return false;
+            }
+            for (; count >= lanes; count -= lanes, front += lanes) {
+                back_end -= lanes;
+                if (mirror_mask_avx2(front, back_end) != 0xFFFFFFFFu)
+                    return false;
+            }
+
+            return mirrored_equal_scalar(front, back_end, count);
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_SSE42 const T* is_sorted_until_sse42(const T* first, const T* last) noexcept {
+            constexpr std::ptrdiff_t lanes = 16 / sizeof(T);
+            for (; last - first > lanes; first += lanes) {
+                unsigned mask = descent_mask_sse42(first);
+                if (mask)
+                    return first + __builtin_ctz(mask) / sizeof(T) + 1;
+            }
+
+            return is_sorted_until_scalar(first, last);
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_AVX2 const T* is_sorted_until_avx2(const T* first, const T* last) noexcept {
+            constexpr std::ptrdiff_t lanes = 32 / sizeof(T);
+            for (; last - first > 2 * lanes; first += 2 * lanes) {
+                unsigned m0 = descent_mask_avx2(first);
+                unsigned m1 = descent_mask_avx2(first + lanes);
+                if (m0 | m1) {
+                    if (m0)
+                        return first + __builtin_ctz(m0) / sizeof(T) + 1;
+                    return first + lanes + __builtin_ctz(m1) / sizeof(T) + 1;
+                }
+            }
+            for (; last - first > lanes; first += lanes) {
+                unsigned mask = descent_mask_avx2(first);
+                if (mask)
+                    return first + __builtin_ctz(mask) / sizeof(T) + 1;
+            }
+
+            return is_sorted_until_scalar(first, last);
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_SSE42 std::size_t count_descents_sse42(const T* first, const T* last) noexcept {
+            constexpr std::ptrdiff_t lanes = 16 / sizeof(T);
+            std::size_t bits = 0;
+            for (; last - first > lanes; first += lanes)
+                bits += __builtin_popcount(descent_mask_sse42(first));
+
+            return bits / sizeof(T) + count_descents_scalar(first, last);
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_AVX2 std::size_t count_descents_avx2(const T* first, const T* last) noexcept {
+            constexpr std::ptrdiff_t lanes = 32 / sizeof(T);
+            std::size_t bits = 0;
+            for (; last - first > lanes; first += lanes)
+                bits += __builtin_popcount(descent_mask_avx2(first));
+
+            return bits / sizeof(T) + count_descents_scalar(first, last);
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_SSE42 const T* find_not_sse42(const T* first, const T* last, T x) noexcept {
+            constexpr std::ptrdiff_t lanes = 16 / sizeof(T);
+            for (; last - first >= lanes; first += lanes) {
+                unsigned mask = ~eq_mask_sse42(first, x) & 0xFFFFu;
+                if (mask)
+                    return first + __builtin_ctz(mask) / sizeof(T);
+            }
+
+            return find_not_scalar(first, last, x);
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_AVX2 const T* find_not_avx2(const T* first, const T* last, T x) noexcept {
+            constexpr std::ptrdiff_t lanes = 32 / sizeof(T);
+            // Four vectors per iteration keep enough loads in flight to saturate the memory bus
+            for (; last - first >= 4 * lanes; first += 4 * lanes) {
+                unsigned m0 = eq_mask_avx2(first, x);
+                unsigned m1 = eq_mask_avx2(first + lanes, x);
+                unsigned m2 = eq_mask_avx2(first + 2 * lanes, x);
+                unsigned m3 = eq_mask_avx2(first + 3 * lanes, x);
+                if ((m0 & m1 & m2 & m3) != 0xFFFFFFFFu) {
+                    if (~m0)
+                        return first + __builtin_ctz(~m0) / sizeof(T);
+                    if (~m1)
+                        return first + lanes + __builtin_ctz(~m1) / sizeof(T);
+                    if (~m2)
+                        return first + 2 * lanes + __builtin_ctz(~m2) / sizeof(T);
+                    return first + 3 * lanes + __builtin_ctz(~m3) / sizeof(T);
+                }
+            }
+            for (; last - first >= lanes; first += lanes) {
+                unsigned mask = ~eq_mask_avx2(first, x);
+                if (mask)
+                    return first + __builtin_ctz(mask) / sizeof(T);
+            }
+
+            return find_not_scalar(first, last, x);
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_SSE42 const T* find_backward_sse42(const T* first, const T* last, T x) noexcept {
+            constexpr std::ptrdiff_t lanes = 16 / sizeof(T);
+            auto p = last;
+            for (; p - first >= lanes; p -= lanes) {
+                unsigned mask = eq_mask_sse42(p - lanes, x);
+                if (mask)
+                    return p - lanes + (31 - __builtin_clz(mask)) / sizeof(T);
+            }
+
+            auto found = find_backward_scalar(first, p, x);
+            return found == p ? last : found;
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_AVX2 const T* find_backward_avx2(const T* first, const T* last, T x) noexcept {
+            constexpr std::ptrdiff_t lanes = 32 / sizeof(T);
+            auto p = last;
+            for (; p - first >= 4 * lanes; p -= 4 * lanes) {
+                unsigned m3 = eq_mask_avx2(p - lanes, x);
+                unsigned m2 = eq_mask_avx2(p - 2 * lanes, x);
+                unsigned m1 = eq_mask_avx2(p - 3 * lanes, x);
+                unsigned m0 = eq_mask_avx2(p - 4 * lanes, x);
+                if (m0 | m1 | m2 | m3) {
+                    if (m3)
+                        return p - lanes + (31 - __builtin_clz(m3)) / sizeof(T);
+                    if (m2)
+                        return p - 2 * lanes + (31 - __builtin_clz(m2)) / sizeof(T);
+                    if (m1)
+                        return p - 3 * lanes + (31 - __builtin_clz(m1)) / sizeof(T);
+                    return p - 4 * lanes + (31 - __builtin_clz(m0)) / sizeof(T);
+                }
+            }
+            for (; p - first >= lanes; p -= lanes) {
+                unsigned mask = eq_mask_avx2(p - lanes, x);
+                if (mask)
+                    return p - lanes + (31 - __builtin_clz(mask)) / sizeof(T);
+            }
+
+            auto found = find_backward_scalar(first, p, x);
+            return found == p ? last : found;
+        }
+
+#endif
+
+        /**
+         * First element of [first, last) that is not equal to x, or last
+         */
+        template<typename T>
+        const T* find_not(const T* first, const T* last, T x) noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            switch (detected_isa()) {
+                case isa::avx2:
+                    return find_not_avx2(first, last, x);
+                case isa::sse42:
+                    return find_not_sse42(first, last, x);
+                default:
+                    break;
+            }
+#endif
+            return find_not_scalar(first, last, x);
+        }
+
+        /**
+         * Last element of [first, last) that is equal to x, or last
+         */
+        template<typename T>
+        const T* find_backward(const T* first, const T* last, T x) noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            switch (detected_isa()) {
+                case isa::avx2:
+                    return find_backward_avx2(first, last, x);
+                case isa::sse42:
+                    return find_backward_sse42(first, last, x);
+                default:
+                    break;
+            }
+#endif
+            return find_backward_scalar(first, last, x);
+        }
+
+        /**
+         * First element of [first, last) that is less than its predecessor, or last
+         */
+        template<typename T>
+        const T* is_sorted_until(const T* first, const T* last) noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            switch (detected_isa()) {
+                case isa::avx2:
+                    return is_sorted_until_avx2(first, last);
+                case isa::sse42:
+                    return is_sorted_until_sse42(first, last);
+                default:
+                    break;
+            }
+#endif
+            return is_sorted_until_scalar(first, last);
+        }
+
+        /**
+         * Number of adjacent pairs of [first, last) where the second element is less than the first
+         */
+        template<typename T>
+        std::size_t count_descents(const T* first, const T* last) noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            switch (detected_isa()) {
+                case isa::avx2:
+                    return count_descents_avx2(first, last);
+                case isa::sse42:
+                    return count_descents_sse42(first, last);
+                default:
+                    break;
+            }
+#endif
+            return count_descents_scalar(first, last);
+        }
+
+        /**
+         * True if front[i] == *(back_end - 1 - i) for every i < count
+         */
+        template<typename T>
+        bool mirrored_equal(const T* front, const T* back_end, std::size_t count) noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            switch (detected_isa()) {
+                case isa::avx2:
+                    return mirrored_equal_avx2(front, back_end, count);
+                case isa::sse42:
+                    return mirrored_equal_sse42(front, back_end, count);
+                default:
+                    break;
+            }
+#endif
+            return mirrored_equal_scalar(front, back_end, count);
+        }
+
+        // Multi-needle search. A matcher tells whether an element is one of the needles, lane-wise
+        // through mask_sse42()/mask_avx2() when it is vectorized and one element at a time otherwise.
+
+        // Largest needle set compared by broadcasting every needle
+        inline constexpr std::size_t small_needle_set = 8;
+
+        template<typename T, std::size_t N>
+        struct needle_matcher {
+            static constexpr bool vectorized = true;
+
+            T needles[N];
+
+            template<typename ForwardIt>
+            explicit needle_matcher(ForwardIt s_first) {
+                for (std::size_t i = 0; i < N; ++i, ++s_first)
+                    needles[i] = *s_first;
+            }
+
+            bool matches(T x) const noexcept {
+                bool found = false;
+                for (std::size_t i = 0; i < N; ++i)
+                    found |= x == needles[i];
+                return found;
+            }
+
+#ifdef PY_ALGO_SIMD_X86
+            PY_ALGO_TARGET_SSE42 unsigned mask_sse42(const T* p) const noexcept {
+                unsigned mask = 0;
+                for (std::size_t i = 0; i < N; ++i)
+                    mask |= eq_mask_sse42(p, needles[i]);
+                return mask;
+            }
+
+            PY_ALGO_TARGET_AVX2 unsigned mask_avx2(const T* p) const noexcept {
+                unsigned mask = 0;
+                for (std::size_t i = 0; i < N; ++i)
+                    mask |= eq_mask_avx2(p, needles[i]);
+                return mask;
+            }
+#endif
+        };
+
+        /**
+         * Any set of bytes as a 16x16 bitmap indexed by the two nibbles. The low nibble picks a
+         * row with pshufb, the high nibble picks the bit: rows for high nibbles 0-7 and 8-15 are
+         * kept in two tables and blended on the sign bit of the byte.
+         */
+        template<typename T>
+        struct byte_set_matcher {
+            static constexpr bool vectorized = true;
+
+            alignas(16) unsigned char low_rows[16] = {};
+            alignas(16) unsigned char high_rows[16] = {};
+
+            template<typename ForwardIt>
+            byte_set_matcher(ForwardIt s_first, std::size_t _count) {
+                for (std::size_t i = 0; i < _count; ++i, ++s_first) {
+                    auto byte = static_cast<unsigned char>(static_cast<T>(*s_first));
+                    (byte < 0x80 ? low_rows : high_rows)[byte & 0x0F] |= static_cast<unsigned char>(1u << ((byte >> 4) & 7));
+                }
+            }
+
+            bool matches(T x) const noexcept {
+                auto byte = static_cast<unsigned char>(x);
+                return ((byte < 0x80 ? low_rows : high_rows)[byte & 0x0F] >> ((byte >> 4) & 7)) & 1u;
+            }
+
+#ifdef PY_ALGO_SIMD_X86
+            PY_ALGO_TARGET_SSE42 unsigned mask_sse42(const T* p) const noexcept {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                __m128i nibble = _mm_set1_epi8(0x0F);
+                __m128i low = _mm_and_si128(v, nibble);
+                __m128i high = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+                __m128i row = _mm_blendv_epi8(
+                    _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(low_rows)), low),
+                    _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(high_rows)), low), v);
+                __m128i bit = _mm_shuffle_epi8(
+                    _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128), high);
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), bit)));
+            }
+
+            PY_ALGO_TARGET_AVX2 unsigned mask_avx2(const T* p) const noexcept {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                __m256i nibble = _mm256_set1_epi8(0x0F);
+                __m256i low = _mm256_and_si256(v, nibble);
+                __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+                __m256i row = _mm256_blendv_epi8(
+                    _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+                        _mm_load_si128(reinterpret_cast<const __m128i*>(low_rows))), low),
+                    _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+                        _mm_load_si128(reinterpret_cast<const __m128i*>(high_rows))), low), v);
+                __m256i bit = _mm256_shuffle_epi8(
+                    _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                     1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128), high);
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit)));
+            }
+#endif
+        };
+
+        /**
+         * Needle sets too large to broadcast: a bitmap over all values of 16-bit types,
+         * a sorted array searched by bisection for wider ones
+         */
+        template<typename T>
+        class needle_lookup {
+        public:
+            static constexpr bool vectorized = false;
+
+        private:
+            std::vector<std::uint64_t> bits;
+            std::vector<T> sorted;
+
+        public:
+            template<typename ForwardIt>
+            needle_lookup(ForwardIt s_first, std::size_t _count) {
+                if constexpr (sizeof(T) <= 2) {
+                    bits.assign((std::size_t(1) << (8 * sizeof(T))) / 64, 0);
+                    for (std::size_t i = 0; i < _count; ++i, ++s_first) {
+                        auto index = static_cast<std::make_unsigned_t<T>>(static_cast<T>(*s_first));
+                        bits[index / 64] |= std::uint64_t(1) << (index % 64);
+                    }
+                } else {
+                    sorted.reserve(_count);
+                    for (std::size_t i = 0; i < _count; ++i, ++s_first) {
+                        T needle = *s_first;
+                        // NaN equals nothing, and would break the ordering
+                        if (needle == needle)
+                            sorted.push_back(needle);
+                    }
+                    std::sort(sorted.begin(), sorted.end());
+                }
+            }
+
+            bool matches(T x) const noexcept {
+                if constexpr (sizeof(T) <= 2) {
+                    auto index = static_cast<std::make_unsigned_t<T>>(x);
+                    return (bits[index / 64] >> (index % 64)) & 1u;
+                } else {
+                    return x == x && std::binary_search(sorted.begin(), sorted.end(), x);
+                }
+            }
+        };
+
+        template<typename T, typename Matcher>
+        const T* find_unmatched_scalar(const T* first, const T* last, const Matcher& m) noexcept {
+            for (; first != last; ++first) {
+                if (!m.matches(*first))
+                    return first;
+            }
+
+            return last;
+        }
+
+        template<typename T, typename Matcher>
+        const T* find_last_matched_scalar(const T* first, const T* last, const Matcher& m) noexcept {
+            for (auto p = last; p != first;) {
+                if (m.matches(*--p))
+                    return p;
+            }
+
+            return last;
+        }
+
+#ifdef PY_ALGO_SIMD_X86
+
+        template<typename T, typename Matcher>
+        PY_ALGO_TARGET_SSE42 const T* find_unmatched_sse42(const T* first, const T* last, const Matcher& m) noexcept {
+            constexpr std::ptrdiff_t lanes = 16 / sizeof(T);
+            for (; last - first >= lanes; first += lanes) {
+                unsigned mask = ~m.mask_sse42(first) & 0xFFFFu;
+                if (mask)
+                    return first + __builtin_ctz(mask) / sizeof(T);
+            }
+
+            return find_unmatched_scalar(first, last, m);
+        }
+
+        template<typename T, typename Matcher>
+        PY_ALGO_TARGET_AVX2 const T* find_unmatched_avx2(const T* first, const T* last, const Matcher& m) noexcept {
+            constexpr std::ptrdiff_t lanes = 32 / sizeof(T);
+            for (; last - first >= 2 * lanes; first += 2 * lanes) {
+                unsigned m0 = m.mask_avx2(first);
+                unsigned m1 = m.mask_avx2(first + lanes);
+                if ((m0 & m1) != 0xFFFFFFFFu) {
+                    if (~m0)
+                        return first + __builtin_ctz(~m0) / sizeof(T);
+                    return first + lanes + __builtin_ctz(~m1) / sizeof(T);
+                }
+            }
+            for (; last - first >= lanes; first += lanes) {
+                unsigned mask = ~m.mask_avx2(first);
+                if (mask)
+                    return first + __builtin_ctz(mask) / sizeof(T);
+            }
+
+            return find_unmatched_scalar(first, last, m);
+        }
+
+        template<typename T, typename Matcher>
+        PY_ALGO_TARGET_SSE42 const T* find_last_matched_sse42(const T* first, const T* last, const Matcher& m) noexcept {
+            constexpr std::ptrdiff_t lanes = 16 / sizeof(T);
+            auto p = last;
+            for (; p - first >= lanes; p -= lanes) {
+                unsigned mask = m.mask_sse42(p - lanes);
+                if (mask)
+                    return p - lanes + (31 - __builtin_clz(mask)) / sizeof(T);
+            }
+
+            auto found = find_last_matched_scalar(first, p, m);
+            return found == p ? last : found;
+        }
+
+        template<typename T, typename Matcher>
+        PY_ALGO_TARGET_AVX2 const T* find_last_matched_avx2(const T* first, const T* last, const Matcher& m) noexcept {
+            constexpr std::ptrdiff_t lanes = 32 / sizeof(T);
+            auto p = last;
+            for (; p - first >= 2 * lanes; p -= 2 * lanes) {
+                unsigned m1 = m.mask_avx2(p - lanes);
+                unsigned m0 = m.mask_avx2(p - 2 * lanes);
+                if (m0 | m1) {
+                    if (m1)
+                        return p - lanes + (31 - __builtin_clz(m1)) / sizeof(T);
+                    return p - 2 * lanes + (31 - __builtin_clz(m0)) / sizeof(T);
+                }
+            }
+            for (; p - first >= lanes; p -= lanes) {
+                unsigned mask = m.mask_avx2(p - lanes);
+                if (mask)
+                    return p - lanes + (31 - __builtin_clz(mask)) / sizeof(T);
+            }
+
+            auto found = find_last_matched_scalar(first, p, m);
+            return found == p ? last : found;
+        }
+
+#endif
+
+        template<typename T, typename Matcher>
+        const T* find_unmatched(const T* first, const T* last, const Matcher& m) noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            if constexpr (Matcher::vectorized) {
+                switch (detected_isa()) {
+                    case isa::avx2:
+                        return find_unmatched_avx2(first, last, m);
+                    case isa::sse42:
+                        return find_unmatched_sse42(first, last, m);
+                    default:
+                        break;
+                }
+            }
+#endif
+            return find_unmatched_scalar(first, last, m);
+        }
+
+        template<typename T, typename Matcher>
+        const T* find_last_matched(const T* first, const T* last, const Matcher& m) noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            if constexpr (Matcher::vectorized) {
+                switch (detected_isa()) {
+                    case isa::avx2:
+                        return find_last_matched_avx2(first, last, m);
+                    case isa::sse42:
+                        return find_last_matched_sse42(first, last, m);
+                    default:
+                        break;
+                }
+            }
+#endif
+            return find_last_matched_scalar(first, last, m);
+        }
+
+        /**
+         * Calls _fn with the matcher suited to _count >= 1 needles: the nibble table for bytes,
+         * a broadcast compare specialized on the count for small sets, a lookup for large ones
+         */
+        template<typename T, typename ForwardIt, typename Function>
+        const T* with_needle_matcher(ForwardIt s_first, std::size_t _count, Function&& _fn) {
+            if constexpr (sizeof(T) == 1) {
+                if (_count > 2)
+                    return _fn(byte_set_matcher<T>(s_first, _count));
+            }
+            switch (_count) {
+                case 1:
+                    return _fn(needle_matcher<T, 1>(s_first));
+                case 2:
+                    return _fn(needle_matcher<T, 2>(s_first));
+                case 3:
+                    return _fn(needle_matcher<T, 3>(s_first));
+                case 4:
+                    return _fn(needle_matcher<T, 4>(s_first));
+                case 5:
+                    return _fn(needle_matcher<T, 5>(s_first));
+                case 6:
+                    return _fn(needle_matcher<T, 6>(s_first));
+                case 7:
+                    return _fn(needle_matcher<T, 7>(s_first));
+                case small_needle_set:
+                    return _fn(needle_matcher<T, small_needle_set>(s_first));
+                default:
+                    return _fn(needle_lookup<T>(s_first, _count));
+            }
+        }
+
+        /**
+         * Calls _fn(needles, count) with the needles in [s_first, s_last) converted to the element
+         * type T, leaving out those no T equals. Needles of type T are passed on as they are.
+         */
+        template<typename T, typename ForwardIt, typename Function>
+        decltype(auto) with_narrowed_needles(ForwardIt s_first, ForwardIt s_last, Function&& _fn) {
+            typedef std::remove_cv_t<typename std::iterator_traits<ForwardIt>::value_type> needle_type;
+            auto total = static_cast<std::size_t>(std::distance(s_first, s_last));
+            if constexpr (std::is_same_v<needle_type, T>) {
+                return _fn(s_first, total);
+            } else {
+                // Sets the matchers broadcast stay on the stack
+                T small[small_needle_set];
+                std::vector<T> large(total > small_needle_set ? total : 0);
+                T* needles = total > small_needle_set ? large.data() : small;
+                std::size_t count = 0;
+                for (; s_first != s_last; ++s_first)
+                    count += narrow_needle(*s_first, needles[count]);
+
+                return _fn(static_cast<const T*>(needles), count);
+            }
+        }
+
+        /**
+         * First element of [first, last) equal to none of the _count needles at s_first, or last
+         */
+        template<typename T, typename ForwardIt>
+        const T* find_not_any_of(const T* first, const T* last, ForwardIt s_first, std::size_t _count) {
+            if (_count == 0)
+                return first;
+
+            return with_needle_matcher<T>(s_first, _count, [first, last](const auto& _m) {
+                return find_unmatched(first, last, _m);
+            });
+        }
+
+        /**
+         * Last element of [first, last) equal to one of the _count needles at s_first, or last
+         */
+        template<typename T, typename ForwardIt>
+        const T* find_backward_any_of(const T* first, const T* last, ForwardIt s_first, std::size_t _count) {
+            if (_count == 0)
+                return last;
+
+            return with_needle_matcher<T>(s_first, _count, [first, last](const auto& _m) {
+                return find_last_matched(first, last, _m);
+            });
+        }
+
+        // Progression fill. Lanes compute start + index * step with the same two roundings as
+        // xrange_iterator, a multiply then an add, so the output matches iteration bit for bit.
+
+        template<typename T>
+        void fill_progression_scalar(T* out, T start, T step, std::ptrdiff_t index, std::size_t count) noexcept {
+            for (std::size_t i = 0; i < count; ++i, ++index)
+                out[i] = static_cast<T>(start + index * step);
+        }
+
+#ifdef PY_ALGO_SIMD_X86
+
+        // Double lane indices stay exact integers below 2^53, as in the scalar conversion
+        inline constexpr std::ptrdiff_t exact_double_index = std::ptrdiff_t(1) << 53;
+
+        PY_ALGO_TARGET_SSE42 inline void fill_progression_sse42(double* out, double start, double step,
+                                                                std::ptrdiff_t index, std::size_t count) noexcept {
+            std::size_t i = 0;
+            if (index + static_cast<std::ptrdiff_t>(count) <= exact_double_index) {
+                const __m128d starts = _mm_set1_pd(start), steps = _mm_set1_pd(step), two = _mm_set1_pd(2.0);
+                __m128d lanes = _mm_add_pd(_mm_set1_pd(static_cast<double>(index)), _mm_setr_pd(0.0, 1.0));
+                for (; i + 2 <= count; i += 2) {
+                    _mm_storeu_pd(out + i, _mm_add_pd(starts, _mm_mul_pd(lanes, steps)));
+                    lanes = _mm_add_pd(lanes, two);
+                }
+            }
+            fill_progression_scalar(out + i, start, step, index + static_cast<std::ptrdiff_t>(i), count - i);
+        }
+
+        PY_ALGO_TARGET_AVX2 inline void fill_progression_avx2(double* out, double start, double step,
+                                                              std::ptrdiff_t index, std::size_t count) noexcept {
+            std::size_t i = 0;
+            if (index + static_cast<std::ptrdiff_t>(count) <= exact_double_index) {
+                const __m256d starts = _mm256_set1_pd(start), steps = _mm256_set1_pd(step), four = _mm256_set1_pd(4.0);
+                __m256d lanes = _mm256_add_pd(_mm256_set1_pd(static_cast<double>(index)), _mm256_setr_pd(0.0, 1.0, 2.0, 3.0));
+                for (; i + 4 <= count; i += 4) {
+                    _mm256_storeu_pd(out + i, _mm256_add_pd(starts, _mm256_mul_pd(lanes, steps)));
+                    lanes = _mm256_add_pd(lanes, four);
+                }
+            }
+            fill_progression_scalar(out + i, start, step, index + static_cast<std::ptrdiff_t>(i), count - i);
+        }
+
+        // Float lanes convert 32-bit indices, which rounds exactly like the scalar conversion
+        PY_ALGO_TARGET_SSE42 inline void fill_progression_sse42(float* out, float start, float step,
+                                                                std::ptrdiff_t index, std::size_t count) noexcept {
+            std::size_t i = 0;
+            if (index + static_cast<std::ptrdiff_t>(count) <= INT32_MAX) {
+                const __m128 starts = _mm_set1_ps(start), steps = _mm_set1_ps(step);
+                const __m128i four = _mm_set1_epi32(4);
+                __m128i lanes = _mm_add_epi32(_mm_set1_epi32(static_cast<std::int32_t>(index)), _mm_setr_epi32(0, 1, 2, 3));
+                for (; i + 4 <= count; i += 4) {
+                    _mm_storeu_ps(out + i, _mm_add_ps(starts, _mm_mul_ps(_mm_cvtepi32_ps(lanes), steps)));
+                    lanes = _mm_add_epi32(lanes, four);
+                }
+            }
+            fill_progression_scalar(out + i, start, step, index + static_cast<std::ptrdiff_t>(i), count - i);
+        }
+
+        PY_ALGO_TARGET_AVX2 inline void fill_progression_avx2(float* out, float start, float step,
+                                                              std::ptrdiff_t index, std::size_t count) noexcept {
+            std::size_t i = 0;
+            if (index + static_cast<std::ptrdiff_t>(count) <= INT32_MAX) {
+                const __m256 starts = _mm256_set1_ps(start), steps = _mm256_set1_ps(step);
+                const __m256i eight = _mm256_set1_epi32(8);
+                __m256i lanes = _mm256_add_epi32(_mm256_set1_epi32(static_cast<std::int32_t>(index)),
+                                                 _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+                for (; i + 8 <= count; i += 8) {
+                    _mm256_storeu_ps(out + i, _mm256_add_ps(starts, _mm256_mul_ps(_mm256_cvtepi32_ps(lanes), steps)));
+                    lanes = _mm256_add_epi32(lanes, eight);
+                }
+            }
+            fill_progression_scalar(out + i, start, step, index + static_cast<std::ptrdiff_t>(i), count - i);
+        }
+
+#endif
+
+        /**
+         * Writes start + (index + i) * step to out[i] for every i < count; T is float or double
+         */
+        template<typename T>
+        void fill_progression(T* out, T start, T step, std::ptrdiff_t index, std::size_t count) noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            switch (detected_isa()) {
+                case isa::avx2:
+                    return fill_progression_avx2(out, start, step, index, count);
+                case isa::sse42:
+                    return fill_progression_sse42(out, start, step, index, count);
+                default:
+                    break;
+            }
+#endif
+            fill_progression_scalar(out, start, step, index, count);
+        }
+
+        // Two-column reductions: inner products of float or double columns and the number of
+        // rows whose two values compare true. Vector kernels keep several partial sums, so a
+        // floating point result may differ from the sequential sum in its last bits.
+
+        template<typename T>
+        T dot_scalar(const T* a, const T* b, std::size_t count) noexcept {
+            T sum = 0;
+            for (std::size_t i = 0; i < count; ++i)
+                sum += a[i] * b[i];
+
+            return sum;
+        }
+
+        enum class pair_compare {
+            equal,
+            not_equal,
+            less,
+            less_equal
+        };
+
+        template<pair_compare Compare, typename T>
+        constexpr bool compare_pair(T a, T b) noexcept {
+            if constexpr (Compare == pair_compare::equal)
+                return a == b;
+            else if constexpr (Compare == pair_compare::not_equal)
+                return a != b;
+            else if constexpr (Compare == pair_compare::less)
+                return a < b;
+            else
+                return a <= b;
+        }
+
+        template<pair_compare Compare, typename T>
+        std::size_t count_pairs_scalar(const T* a, const T* b, std::size_t count) noexcept {
+            std::size_t matches = 0;
+            for (std::size_t i = 0; i < count; ++i)
+                matches += compare_pair<Compare>(a[i], b[i]);
+
+            return matches;
+        }
+
+#ifdef PY_ALGO_SIMD_X86
+
+        // Four accumulators hide the latency of the adds
+        template<typename T>
+        PY_ALGO_TARGET_SSE42 T dot_sse42(const T* a, const T* b, std::size_t count) noexcept {
+            std::size_t i = 0;
+            if constexpr (std::is_same_v<T, float>) {
+                __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+                for (; i + 16 <= count; i += 16) {
+                    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+                    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+                    acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(a + i + 8), _mm_loadu_ps(b + i + 8)));
+                    acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+                }
+                alignas(16) float lanes[4];
+                _mm_store_ps(lanes, _mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+                return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + dot_scalar(a + i, b + i, count - i);
+            } else {
+                __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+                for (; i + 8 <= count; i += 8) {
+                    acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+                    acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+                    acc2 = _mm_add_pd(acc2, _mm_mul_pd(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4)));
+                    acc3 = _mm_add_pd(acc3, _mm_mul_pd(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6)));
+                }
+                alignas(16) double lanes[2];
+                _mm_store_pd(lanes, _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+                return (lanes[0] + lanes[1]) + dot_scalar(a + i, b + i, count - i);
+            }
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_FMA T dot_fma(const T* a, const T* b, std::size_t count) noexcept {
+            std::size_t i = 0;
+            if constexpr (std::is_same_v<T, float>) {
+                __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+                for (; i + 32 <= count; i += 32) {
+                    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+                    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+                    acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), acc2);
+                    acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), acc3);
+                }
+                for (; i + 8 <= count; i += 8)
+                    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+                __m256 acc = _mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3));
+                __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+                alignas(16) float lanes[4];
+                _mm_store_ps(lanes, half);
+                return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + dot_scalar(a + i, b + i, count - i);
+            } else {
+                __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd(), acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+                for (; i + 16 <= count; i += 16) {
+                    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+                    acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+                    acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), acc2);
+                    acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), acc3);
+                }
+                for (; i + 4 <= count; i += 4)
+                    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+                __m256d acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+                __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+                alignas(16) double lanes[2];
+                _mm_store_pd(lanes, half);
+                return (lanes[0] + lanes[1]) + dot_scalar(a + i, b + i, count - i);
+            }
+        }
+
+        // Byte mask of lanes where x > y, in the order of T
+
+        template<typename T>
+        PY_ALGO_TARGET_SSE42 inline unsigned greater_mask_sse42(__m128i x, __m128i y) noexcept {
+            if constexpr (std::is_unsigned_v<T>) {
+                // Flipping the sign bit maps unsigned order onto the signed compare
+                __m128i bias;
+                if constexpr (sizeof(T) == 1)
+                    bias = _mm_set1_epi8(static_cast<char>(0x80));
+                else if constexpr (sizeof(T) == 2)
+                    bias = _mm_set1_epi16(static_cast<short>(0x8000));
+                else if constexpr (sizeof(T) == 4)
+                    bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+                else
+                    bias = _mm_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+                x = _mm_xor_si128(x, bias);
+                y = _mm_xor_si128(y, bias);
+            }
+            if constexpr (sizeof(T) == 1)
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(x, y)));
+            else if constexpr (sizeof(T) == 2)
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi16(x, y)));
+            else if constexpr (sizeof(T) == 4)
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi32(x, y)));
+            else
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi64(x, y)));
+        }
+
+        template<typename T>
+        PY_ALGO_TARGET_AVX2 inline unsigned greater_mask_avx2(__m256i x, __m256i y) noexcept {
+            if constexpr (std::is_unsigned_v<T>) {
+                __m256i bias;
+                if constexpr (sizeof(T) == 1)
+                    bias = _mm256_set1_epi8(static_cast<char>(0x80));
+                else if constexpr (sizeof(T) == 2)
+                    bias = _mm256_set1_epi16(static_cast<short>(0x8000));
+                else if constexpr (sizeof(T) == 4)
+                    bias = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+                else
+                    bias = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+                x = _mm256_xor_si256(x, bias);
+                y = _mm256_xor_si256(y, bias);
+            }
+            if constexpr (sizeof(T) == 1)
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(x, y)));
+            else if constexpr (sizeof(T) == 2)
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi16(x, y)));
+            else if constexpr (sizeof(T) == 4)
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi32(x, y)));
+            else
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi64(x, y)));
+        }
+
+        // Byte mask of lanes i where compare_pair<Compare>(a[i], b[i])
+
+        template<pair_compare Compare, typename T>
+        PY_ALGO_TARGET_SSE42 inline unsigned pair_mask_sse42(const T* a, const T* b) noexcept {
+            if constexpr (std::is_same_v<T, float>) {
+                __m128 x = _mm_loadu_ps(a), y = _mm_loadu_ps(b), mask;
+                if constexpr (Compare == pair_compare::equal)
+                    mask = _mm_cmpeq_ps(x, y);
+                else if constexpr (Compare == pair_compare::not_equal)
+                    mask = _mm_cmpneq_ps(x, y);
+                else if constexpr (Compare == pair_compare::less)
+                    mask = _mm_cmplt_ps(x, y);
+                else
+                    mask = _mm_cmple_ps(x, y);
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_castps_si128(mask)));
+            } else if constexpr (std::is_same_v<T, double>) {
+                __m128d x = _mm_loadu_pd(a), y = _mm_loadu_pd(b), mask;
+                if constexpr (Compare == pair_compare::equal)
+                    mask = _mm_cmpeq_pd(x, y);
+                else if constexpr (Compare == pair_compare::not_equal)
+                    mask = _mm_cmpneq_pd(x, y);
+                else if constexpr (Compare == pair_compare::less)
+                    mask = _mm_cmplt_pd(x, y);
+                else
+                    mask = _mm_cmple_pd(x, y);
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_castpd_si128(mask)));
+            } else {
+                // Integers have no not-equal or less-equal compare, those are the complements of == and >
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+                __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+                if constexpr (Compare == pair_compare::equal || Compare == pair_compare::not_equal) {
+                    __m128i eq;
+                    if constexpr (sizeof(T) == 1)
+                        eq = _mm_cmpeq_epi8(x, y);
+                    else if constexpr (sizeof(T) == 2)
+                        eq = _mm_cmpeq_epi16(x, y);
+                    else if constexpr (sizeof(T) == 4)
+                        eq = _mm_cmpeq_epi32(x, y);
+                    else
+                        eq = _mm_cmpeq_epi64(x, y);
+                    auto mask = static_cast<unsigned>(_mm_movemask_epi8(eq));
+                    return Compare == pair_compare::equal ? mask : ~mask & 0xFFFFu;
+                } else if constexpr (Compare == pair_compare::less) {
+                    return greater_mask_sse42<T>(y, x);
+                } else {
+                    return ~greater_mask_sse42<T>(x, y) & 0xFFFFu;
+                }
+            }
+        }
+
+        template<pair_compare Compare, typename T>
+        PY_ALGO_TARGET_AVX2 inline unsigned pair_mask_avx2(const T* a, const T* b) noexcept {
+            if constexpr (std::is_same_v<T, float>) {
+                constexpr int predicate = Compare == pair_compare::equal ? _CMP_EQ_OQ
+                                        : Compare == pair_compare::not_equal ? _CMP_NEQ_UQ
+                                        : Compare == pair_compare::less ? _CMP_LT_OQ : _CMP_LE_OQ;
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(
+                    _mm256_cmp_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b), predicate))));
+            } else if constexpr (std::is_same_v<T, double>) {
+                constexpr int predicate = Compare == pair_compare::equal ? _CMP_EQ_OQ
+                                        : Compare == pair_compare::not_equal ? _CMP_NEQ_UQ
+                                        : Compare == pair_compare::less ? _CMP_LT_OQ : _CMP_LE_OQ;
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(
+                    _mm256_cmp_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b), predicate))));
+            } else {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+                if constexpr (Compare == pair_compare::equal || Compare == pair_compare::not_equal) {
+                    __m256i eq;
+                    if constexpr (sizeof(T) == 1)
+                        eq = _mm256_cmpeq_epi8(x, y);
+                    else if constexpr (sizeof(T) == 2)
+                        eq = _mm256_cmpeq_epi16(x, y);
+                    else if constexpr (sizeof(T) == 4)
+                        eq = _mm256_cmpeq_epi32(x, y);
+                    else
+                        eq = _mm256_cmpeq_epi64(x, y);
+                    auto mask = static_cast<unsigned>(_mm256_movemask_epi8(eq));
+                    return Compare == pair_compare::equal ? mask : ~mask;
+                } else if constexpr (Compare == pair_compare::less) {
+                    return greater_mask_avx2<T>(y, x);
+                } else {
+                    return ~greater_mask_avx2<T>(x, y);
+                }
+            }
+        }
+
+        template<pair_compare Compare, typename T>
+        PY_ALGO_TARGET_SSE42 std::size_t count_pairs_sse42(const T* a, const T* b, std::size_t count) noexcept {
+            constexpr std::size_t lanes = 16 / sizeof(T);
+            std::size_t bits = 0, i = 0;
+            for (; i + lanes <= count; i += lanes)
+                bits += __builtin_popcount(pair_mask_sse42<Compare>(a + i, b + i));
+
+            return bits / sizeof(T) + count_pairs_scalar<Compare>(a + i, b + i, count - i);
+        }
+
+        template<pair_compare Compare, typename T>
+        PY_ALGO_TARGET_AVX2 std::size_t count_pairs_avx2(const T* a, const T* b, std::size_t count) noexcept {
+            constexpr std::size_t lanes = 32 / sizeof(T);
+            std::size_t bits = 0, i = 0;
+            for (; i + 2 * lanes <= count; i += 2 * lanes) {
+                bits += __builtin_popcount(pair_mask_avx2<Compare>(a + i, b + i));
+                bits += __builtin_popcount(pair_mask_avx2<Compare>(a + i + lanes, b + i + lanes));
+            }
+            for (; i + lanes <= count; i += lanes)
+                bits += __builtin_popcount(pair_mask_avx2<Compare>(a + i, b + i));
+
+            return bits / sizeof(T) + count_pairs_scalar<Compare>(a + i, b + i, count - i);
+        }
+
+#endif
+
+        /**
+         * Sum of a[i] * b[i] for every i < count; T is float or double
+         */
+        template<typename T>
+        T dot(const T* a, const T* b, std::size_t count) noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            if (detected_isa() == isa::avx2 && has_fma())
+                return dot_fma(a, b, count);
+            if (detected_isa() != isa::scalar)
+                return dot_sse42(a, b, count);
+#endif
+            return dot_scalar(a, b, count);
+        }
+
+        /**
+         * Number of i < count where compare_pair<Compare>(a[i], b[i])
+         */
+        template<pair_compare Compare, typename T>
+        std::size_t count_pairs(const T* a, const T* b, std::size_t count) noexcept {
+#ifdef PY_ALGO_SIMD_X86
+            switch (detected_isa()) {
+                case isa::avx2:
+                    return count_pairs_avx2<Compare>(a, b, count);
+                case isa::sse42:
+                    return count_pairs_sse42<Compare>(a, b, count);
+                default:
+                    break;
+            }
+#endif
+            return count_pairs_scalar<Compare>(a, b, count);
+        }
+
+    } // namespace detail::simd
+
+#endif
+} // namespace py_algo
+
+#endif //PY_ALGO_SIMD_H
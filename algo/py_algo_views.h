@@ -0,0 +1,623 @@
+#ifndef PY_ALGO_VIEWS_H
+#define PY_ALGO_VIEWS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "py_algo.h"
+
+namespace py_algo {
+#if __cplusplus >= 201703L
+
+    // Lazy views over containers, xrange, zip and other views, chained with operator|:
+    //
+    //     auto squares = py_algo::xrange<int>(0, 100)
+    //                  | py_algo::views::filter([](int x) { return x % 2 == 0; })
+    //                  | py_algo::views::transform([](int x) { return x * x; });
+    //     py_algo::all_of(squares.begin(), squares.end(), ...);
+    //
+    // Nothing is materialized: every view iterator wraps the iterator below it, so a loop over
+    // the chain inlines into a single loop over the source. An lvalue source is referenced and
+    // must outlive the view, an rvalue source (a temporary xrange, zip or view) is moved in.
+
+    namespace detail {
+
+        template<class Range>
+        using stored_range_t = std::conditional_t<std::is_lvalue_reference_v<Range>, Range,
+            std::remove_cv_t<std::remove_reference_t<Range>>>;
+
+        // Iterator of a stored range; a referenced range keeps its constness
+        template<class Stored>
+        using stored_iterator_t = decltype(std::begin(std::declval<const Stored&>()));
+
+        template<class Iterator>
+        using iterator_category_t = typename std::iterator_traits<Iterator>::iterator_category;
+
+        // Weaker of an iterator's category and Cap
+        template<class Iterator, class Cap>
+        using capped_category_t = std::conditional_t<std::is_base_of_v<Cap, iterator_category_t<Iterator>>,
+            Cap, iterator_category_t<Iterator>>;
+
+    } // namespace detail
+
+    /**
+     * Iterator over the elements satisfying a predicate. It skips to the next match
+     * on increment, so it needs the end of the underlying range.
+     */
+    template<class Iterator, class Predicate>
+    class filter_iterator {
+    public:
+        typedef typename std::iterator_traits<Iterator>::value_type value_type;
+        typedef typename std::iterator_traits<Iterator>::reference reference;
+        typedef typename std::iterator_traits<Iterator>::pointer pointer;
+        typedef typename std::iterator_traits<Iterator>::difference_type difference_type;
+        typedef detail::capped_category_t<Iterator, std::forward_iterator_tag> iterator_category;
+
+    private:
+        Iterator stored_iter;
+        Iterator stored_end;
+        const Predicate* stored_pred;
+
+    public:
+        filter_iterator() : stored_iter(), stored_end(), stored_pred(nullptr) {}
+
+        filter_iterator(Iterator _iter, Iterator _end, const Predicate* _pred)
+            : stored_iter(_iter), stored_end(_end), stored_pred(_pred) {
+            satisfy();
+        }
+
+        Iterator base() const {
+            return stored_iter;
+        }
+
+        reference operator*() const {
+            return *stored_iter;
+        }
+
+        filter_iterator& operator++() {
+            ++stored_iter;
+            satisfy();
+            return *this;
+        }
+
+        filter_iterator operator++(int) {
+            auto old_iter = *this;
+            ++*this;
+            return old_iter;
+        }
+
+        friend bool operator==(const filter_iterator& _l, const filter_iterator& _r) {
+            return _l.stored_iter == _r.stored_iter;
+        }
+
+        friend bool operator!=(const filter_iterator& _l, const filter_iterator& _r) {
+            return !(_l == _r);
+        }
+
+    private:
+        void satisfy() {
+            while (stored_iter != stored_end && !(*stored_pred)(*stored_iter))
+                ++stored_iter;
+        }
+    };
+
+    /**
+     * Iterator applying a function on dereference. It keeps the category of the underlying
+     * iterator and, like xrange_iterator, yields the result by value.
+     */
+    template<class Iterator, class Function>
+    class transform_iterator {
+    public:
+        typedef decltype(std::declval<const Function&>()(*std::declval<Iterator>())) reference;
+        typedef std::remove_cv_t<std::remove_reference_t<reference>> value_type;
+        typedef void pointer;
+        typedef typename std::iterator_traits<Iterator>::difference_type difference_type;
+        typedef detail::iterator_category_t<Iterator> iterator_category;
+
+    private:
+        Iterator stored_iter;
+        const Function* stored_fn;
+
+    public:
+        transform_iterator() : stored_iter(), stored_fn(nullptr) {}
+
+        transform_iterator(Iterator _iter, const Function* _fn) : stored_iter(_iter), stored_fn(_fn) {}
+
+        Iterator base() const {
+            return stored_iter;
+        }
+
+        reference operator*() const {
+            return (*stored_fn)(*stored_iter);
+        }
+
+        reference operator[](difference_type _n) const {
+            return (*stored_fn)(stored_iter[_n]);
+        }
+
+        transform_iterator& operator++() {
+            ++stored_iter;
+            return *this;
+        }
+
+        transform_iterator operator++(int) {
+            auto old_iter = *this;
+            ++stored_iter;
+            return old_iter;
+        }
+
+        transform_iterator& operator--() {
+            --stored_iter;
+            return *this;
+        }
+
+        transform_iterator operator--(int) {
+            auto old_iter = *this;
+            --stored_iter;
+            return old_iter;
+        }
+
+        transform_iterator& operator+=(difference_type _n) {
+            stored_iter += _n;
+            return *this;
+        }
+
+        transform_iterator& operator-=(difference_type _n) {
+            stored_iter -= _n;
+            return *this;
+        }
+
+        transform_iterator operator+(difference_type _n) const {
+            return transform_iterator(stored_iter + _n, stored_fn);
+        }
+
+        transform_iterator operator-(difference_type _n) const {
+            return transform_iterator(stored_iter - _n, stored_fn);
+        }
+
+        difference_type operator-(const transform_iterator& _other) const {
+            return stored_iter - _other.stored_iter;
+        }
+
+        friend transform_iterator operator+(difference_type _n, const transform_iterator& _iter) {
+            return _iter + _n;
+        }
+
+        friend bool operator==(const transform_iterator& _l, const transform_iterator& _r) {
+            return _l.stored_iter == _r.stored_iter;
+        }
+
+        friend bool operator!=(const transform_iterator& _l, const transform_iterator& _r) {
+            return !(_l == _r);
+        }
+
+        friend bool operator<(const transform_iterator& _l, const transform_iterator& _r) {
+            return _l.stored_iter < _r.stored_iter;
+        }
+
+        friend bool operator>(const transform_iterator& _l, const transform_iterator& _r) {
+            return _r < _l;
+        }
+
+        friend bool operator<=(const transform_iterator& _l, const transform_iterator& _r) {
+            return !(_r < _l);
+        }
+
+        friend bool operator>=(const transform_iterator& _l, const transform_iterator& _r) {
+            return !(_l < _r);
+        }
+    };
+
+    /**
+     * Iterator over at most n elements. It counts the elements left, and two positions
+     * match when either the counts or the underlying iterators match, so the end of
+     * a shorter underlying range also ends the view.
+     */
+    template<class Iterator>
+    class take_iterator {
+    public:
+        typedef typename std::iterator_traits<Iterator>::value_type value_type;
+        typedef typename std::iterator_traits<Iterator>::reference reference;
+        typedef typename std::iterator_traits<Iterator>::pointer pointer;
+        typedef typename std::iterator_traits<Iterator>::difference_type difference_type;
+        typedef detail::iterator_category_t<Iterator> iterator_category;
+
+    private:
+        Iterator stored_iter;
+        difference_type stored_left;
+
+    public:
+        take_iterator() : stored_iter(), stored_left() {}
+
+        take_iterator(Iterator _iter, difference_type _left) : stored_iter(_iter), stored_left(_left) {}
+
+        Iterator base() const {
+            return stored_iter;
+        }
+
+        reference operator*() const {
+            return *stored_iter;
+        }
+
+        reference operator[](difference_type _n) const {
+            return stored_iter[_n];
+        }
+
+        take_iterator& operator++() {
+            ++stored_iter;
+            --stored_left;
+            return *this;
+        }
+
+        take_iterator operator++(int) {
+            auto old_iter = *this;
+            ++*this;
+            return old_iter;
+        }
+
+        take_iterator& operator--() {
+            --stored_iter;
+            ++stored_left;
+            return *this;
+        }
+
+        take_iterator operator--(int) {
+            auto old_iter = *this;
+            --*this;
+            return old_iter;
+        }
+
+        take_iterator& operator+=(difference_type _n) {
+            stored_iter += _n;
+            stored_left -= _n;
+            return *this;
+        }
+
+        take_iterator& operator-=(difference_type _n) {
+            return *this += -_n;
+        }
+
+        take_iterator operator+(difference_type _n) const {
+            return take_iterator(stored_iter + _n, stored_left - _n);
+        }
+
+        take_iterator operator-(difference_type _n) const {
+            return *this + -_n;
+        }
+
+        difference_type operator-(const take_iterator& _other) const {
+            return _other.stored_left - stored_left;
+        }
+
+        friend take_iterator operator+(difference_type _n, const take_iterator& _iter) {
+            return _iter + _n;
+        }
+
+        friend bool operator==(const take_iterator& _l, const take_iterator& _r) {
+            return _l.stored_left == _r.stored_left || _l.stored_iter == _r.stored_iter;
+        }
+
+        friend bool operator!=(const take_iterator& _l, const take_iterator& _r) {
+            return !(_l == _r);
+        }
+
+        friend bool operator<(const take_iterator& _l, const take_iterator& _r) {
+            return _l.stored_left > _r.stored_left;
+        }
+
+        friend bool operator>(const take_iterator& _l, const take_iterator& _r) {
+            return _r < _l;
+        }
+
+        friend bool operator<=(const take_iterator& _l, const take_iterator& _r) {
+            return !(_r < _l);
+        }
+
+        friend bool operator>=(const take_iterator& _l, const take_iterator& _r) {
+            return !(_l < _r);
+        }
+    };
+
+    /**
+     * Iterator yielding std::pair(index, element). The element is a reference when the
+     * underlying iterator yields one, so it can be assigned through.
+     */
+    template<class Iterator>
+    class enumerate_iterator {
+    public:
+        typedef std::pair<std::size_t, typename std::iterator_traits<Iterator>::value_type> value_type;
+        typedef std::pair<std::size_t, typename std::iterator_traits<Iterator>::reference> reference;
+        typedef void pointer;
+        typedef typename std::iterator_traits<Iterator>::difference_type difference_type;
+        typedef detail::iterator_category_t<Iterator> iterator_category;
+
+    private:
+        Iterator stored_iter;
+        std::size_t stored_index;
+
+    public:
+        enumerate_iterator() : stored_iter(), stored_index() {}
+
+        enumerate_iterator(Iterator _iter, std::size_t _index) : stored_iter(_iter), stored_index(_index) {}
+
+        Iterator base() const {
+            return stored_iter;
+        }
+
+        std::size_t index() const noexcept {
+            return stored_index;
+        }
+
+        reference operator*() const {
+            return reference(stored_index, *stored_iter);
+        }
+
+        reference operator[](difference_type _n) const {
+            return reference(stored_index + _n, stored_iter[_n]);
+        }
+
+        enumerate_iterator& operator++() {
+            ++stored_iter;
+            ++stored_index;
+            return *this;
+        }
+
+        enumerate_iterator operator++(int) {
+            auto old_iter = *this;
+            ++*this;
+            return old_iter;
+        }
+
+        enumerate_iterator& operator--() {
+            --stored_iter;
+            --stored_index;
+            return *this;
+        }
+
+        enumerate_iterator operator--(int) {
+            auto old_iter = *this;
+            --*this;
+            return old_iter;
+        }
+
+        enumerate_iterator& operator+=(difference_type _n) {
+            stored_iter += _n;
+            stored_index += _n;
+            return *this;
+        }
+
+        enumerate_iterator& operator-=(difference_type _n) {
+            return *this += -_n;
+        }
+
+        enumerate_iterator operator+(difference_type _n) const {
+            return enumerate_iterator(stored_iter + _n, stored_index + _n);
+        }
+
+        enumerate_iterator operator-(difference_type _n) const {
+            return *this + -_n;
+        }
+
+        difference_type operator-(const enumerate_iterator& _other) const {
+            return stored_iter - _other.stored_iter;
+        }
+
+        friend enumerate_iterator operator+(difference_type _n, const enumerate_iterator& _iter) {
+            return _iter + _n;
+        }
+
+        friend bool operator==(const enumerate_iterator& _l, const enumerate_iterator& _r) {
+            return _l.stored_iter == _r.stored_iter;
+        }
+
+        friend bool operator!=(const enumerate_iterator& _l, const enumerate_iterator& _r) {
+            return !(_l == _r);
+        }
+
+        friend bool operator<(const enumerate_iterator& _l, const enumerate_iterator& _r) {
+            return _l.stored_iter < _r.stored_iter;
+        }
+
+        friend bool operator>(const enumerate_iterator& _l, const enumerate_iterator& _r) {
+            return _r < _l;
+        }
+
+        friend bool operator<=(const enumerate_iterator& _l, const enumerate_iterator& _r) {
+            return !(_r < _l);
+        }
+
+        friend bool operator>=(const enumerate_iterator& _l, const enumerate_iterator& _r) {
+            return !(_l < _r);
+        }
+    };
+
+    template<class Range, class Predicate>
+    class filter_view {
+    public:
+        typedef filter_iterator<detail::stored_iterator_t<detail::stored_range_t<Range>>, Predicate> iterator;
+        typedef typename iterator::value_type value_type;
+        typedef typename iterator::reference reference;
+
+    private:
+        detail::stored_range_t<Range> stored_range;
+        Predicate stored_pred;
+
+    public:
+        filter_view(Range&& _range, Predicate _pred)
+            : stored_range(std::forward<Range>(_range)), stored_pred(std::move(_pred)) {}
+
+        iterator begin() const {
+            return iterator(std::begin(stored_range), std::end(stored_range), &stored_pred);
+        }
+
+        iterator end() const {
+            return iterator(std::end(stored_range), std::end(stored_range), &stored_pred);
+        }
+    };
+
+    template<class Range, class Function>
+    class transform_view {
+    public:
+        typedef transform_iterator<detail::stored_iterator_t<detail::stored_range_t<Range>>, Function> iterator;
+        typedef typename iterator::value_type value_type;
+        typedef typename iterator::reference reference;
+
+    private:
+        detail::stored_range_t<Range> stored_range;
+        Function stored_fn;
+
+    public:
+        transform_view(Range&& _range, Function _fn)
+            : stored_range(std::forward<Range>(_range)), stored_fn(std::move(_fn)) {}
+
+        iterator begin() const {
+            return iterator(std::begin(stored_range), &stored_fn);
+        }
+
+        iterator end() const {
+            return iterator(std::end(stored_range), &stored_fn);
+        }
+    };
+
+    template<class Range>
+    class take_view {
+    public:
+        typedef take_iterator<detail::stored_iterator_t<detail::stored_range_t<Range>>> iterator;
+        typedef typename iterator::value_type value_type;
+        typedef typename iterator::reference reference;
+        typedef typename iterator::difference_type difference_type;
+
+    private:
+        detail::stored_range_t<Range> stored_range;
+        difference_type stored_count;
+
+    public:
+        // A negative count takes nothing, like zero
+        take_view(Range&& _range, difference_type _count)
+            : stored_range(std::forward<Range>(_range)), stored_count(std::max<difference_type>(0, _count)) {}
+
+        iterator begin() const {
+            return iterator(std::begin(stored_range), stored_count);
+        }
+
+        iterator end() const {
+            if constexpr (std::is_base_of_v<std::random_access_iterator_tag, typename iterator::iterator_category>) {
+                auto size = std::end(stored_range) - std::begin(stored_range);
+                return begin() + std::min(stored_count, size);
+            } else {
+                return iterator(std::end(stored_range), 0);
+            }
+        }
+    };
+
+    template<class Range>
+    class enumerate_view {
+    public:
+        typedef enumerate_iterator<detail::stored_iterator_t<detail::stored_range_t<Range>>> iterator;
+        typedef typename iterator::value_type value_type;
+        typedef typename iterator::reference reference;
+
+    private:
+        detail::stored_range_t<Range> stored_range;
+        std::size_t stored_start;
+
+    public:
+        explicit enumerate_view(Range&& _range, std::size_t _start = 0)
+            : stored_range(std::forward<Range>(_range)), stored_start(_start) {}
+
+        iterator begin() const {
+            return iterator(std::begin(stored_range), stored_start);
+        }
+
+        iterator end() const {
+            if constexpr (std::is_base_of_v<std::random_access_iterator_tag, typename iterator::iterator_category>)
+                return begin() + (std::end(stored_range) - std::begin(stored_range));
+            else
+                return iterator(std::end(stored_range), 0);
+        }
+    };
+
+    /**
+     * Python-like enumerate: pairs every element of _range with its index, counting from _start.
+     * The element is a reference into _range when its iterators yield references.
+     */
+    template<class Range>
+    enumerate_view<Range> enumerate(Range&& _range, std::size_t _start = 0) {
+        return enumerate_view<Range>(std::forward<Range>(_range), _start);
+    }
+
+    namespace views {
+
+        template<class Predicate>
+        struct filter_adaptor {
+            Predicate pred;
+        };
+
+        template<class Function>
+        struct transform_adaptor {
+            Function fn;
+        };
+
+        struct take_adaptor {
+            std::ptrdiff_t count;
+        };
+
+        struct enumerate_adaptor {};
+
+        /**
+         * Keeps the elements for which _pred returns true
+         */
+        template<class Predicate>
+        filter_adaptor<Predicate> filter(Predicate _pred) {
+            return {std::move(_pred)};
+        }
+
+        /**
+         * Replaces every element x with _fn(x)
+         */
+        template<class Function>
+        transform_adaptor<Function> transform(Function _fn) {
+            return {std::move(_fn)};
+        }
+
+        /**
+         * Keeps the first _count elements
+         */
+        inline take_adaptor take(std::ptrdiff_t _count) {
+            return {_count};
+        }
+
+        /**
+         * Pairs every element with its index
+         */
+        inline constexpr enumerate_adaptor enumerate{};
+
+        template<class Range, class Predicate>
+        filter_view<Range, Predicate> operator|(Range&& _range, filter_adaptor<Predicate> _adaptor) {
+            return filter_view<Range, Predicate>(std::forward<Range>(_range), std::move(_adaptor.pred));
+        }
+
+        template<class Range, class Function>
+        transform_view<Range, Function> operator|(Range&& _range, transform_adaptor<Function> _adaptor) {
+            return transform_view<Range, Function>(std::forward<Range>(_range), std::move(_adaptor.fn));
+        }
+
+        template<class Range>
+        take_view<Range> operator|(Range&& _range, take_adaptor _adaptor) {
+            return take_view<Range>(std::forward<Range>(_range), _adaptor.count);
+        }
+
+        template<class Range>
+        enumerate_view<Range> operator|(Range&& _range, enumerate_adaptor) {
+            return enumerate_view<Range>(std::forward<Range>(_range));
+        }
+
+    } // namespace views
+
+#endif
+} // namespace py_algo
+
+#endif //PY_ALGO_VIEWS_H
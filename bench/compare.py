@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""Compare two py_algo_bench JSON reports and flag regressions.
+
+Produce the reports with
+
+    py_algo_bench --benchmark_out=baseline.json --benchmark_out_format=json
+    py_algo_bench --benchmark_out=contender.json --benchmark_out_format=json
+
+or with the py_algo_bench_json build target, then run
+
+    compare.py baseline.json contender.json [--threshold 0.05] [--metric cpu_time]
+
+The script prints the time ratio of every benchmark present in both reports and
+exits with status 1 when any benchmark got slower by more than the threshold.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path, metric):
+    with open(path) as report:
+        benchmarks = json.load(report)["benchmarks"]
+
+    # With --benchmark_repetitions only the median is compared
+    has_aggregates = any(b.get("run_type") == "aggregate" for b in benchmarks)
+    times = {}
+    for b in benchmarks:
+        if has_aggregates:
+            if b.get("aggregate_name") != "median":
+                continue
+            name = b["run_name"]
+        else:
+            name = b["name"]
+        times[name] = b[metric]
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative slowdown reported as a regression (default 0.05)")
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"], default="cpu_time")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline, args.metric)
+    contender = load(args.contender, args.metric)
+    common = [name for name in baseline if name in contender]
+    if not common:
+        print("no benchmarks in common", file=sys.stderr)
+        return 2
+
+    width = max(len(name) for name in common)
+    regressions = 0
+    for name in common:
+        ratio = contender[name] / baseline[name] if baseline[name] else float("inf")
+        mark = ""
+        if ratio > 1 + args.threshold:
+            mark = "  REGRESSION"
+            regressions += 1
+        elif ratio < 1 - args.threshold:
+            mark = "  faster"
+        print(f"{name:<{width}}  {baseline[name]:>14.1f}  {contender[name]:>14.1f}  {ratio:>7.3f}{mark}")
+
+    missing = len(baseline) - len(common)
+    if missing:
+        print(f"{missing} baseline benchmarks missing from the contender", file=sys.stderr)
+    print(f"{regressions} of {len(common)} benchmarks slower by more than {args.threshold:.0%}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
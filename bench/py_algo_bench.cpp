@@ -0,0 +1,965 @@
+#include "algo/py_algo.h"
+#include "algo/py_algo_run_index.h"
+#include "algo/py_algo_views.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Every algorithm of py_algo.h runs against its std:: and std::ranges:: counterpart
+// and against a hand-written loop, over element types from int8 to std::string, buffer
+// sizes from L1-resident to DRAM-sized, and data that lets the scan exit early or late.
+//
+//     py_algo_bench --benchmark_filter='all_of<int32>' --benchmark_out=run.json --benchmark_out_format=json
+//     bench/compare.py baseline.json run.json
+
+enum class implementation {
+    py_algo,
+    std_algo,
+    std_ranges,
+    raw_loop
+};
+
+const char* implementation_name(implementation impl) {
+    switch (impl) {
+        case implementation::py_algo:
+            return "py_algo";
+        case implementation::std_algo:
+            return "std";
+        case implementation::std_ranges:
+            return "ranges";
+        default:
+            return "loop";
+    }
+}
+
+enum class exit_point {
+    early,
+    late
+};
+
+template<typename T>
+const char* type_name();
+
+template<>
+const char* type_name<std::int8_t>() { return "int8"; }
+
+template<>
+const char* type_name<std::int16_t>() { return "int16"; }
+
+template<>
+const char* type_name<std::int32_t>() { return "int32"; }
+
+template<>
+const char* type_name<std::int64_t>() { return "int64"; }
+
+template<>
+const char* type_name<float>() { return "float"; }
+
+template<>
+const char* type_name<double>() { return "double"; }
+
+template<>
+const char* type_name<std::string>() { return "string"; }
+
+// Values ordered like k for k in [0, 101], so every type can express the same data sets
+template<typename T>
+T make_value(int k) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        std::string value = std::to_string(k);
+        return std::string(3 - value.size(), '0') + value;
+    } else {
+        return static_cast<T>(k);
+    }
+}
+
+// Position where an early-exit scan stops, measured from the side it starts on
+std::size_t early_position(std::size_t size) {
+    return size / 100;
+}
+
+template<typename T>
+struct dataset {
+    std::vector<T> data;
+    T needle;
+};
+
+// all_of: every element equals the needle except one
+
+struct all_of_case {
+    static constexpr const char* name = "all_of";
+
+    template<typename T>
+    static dataset<T> make(std::size_t size, exit_point exit) {
+        dataset<T> set{std::vector<T>(size, make_value<T>(1)), make_value<T>(1)};
+        set.data[exit == exit_point::early ? early_position(size) : size - 1] = make_value<T>(2);
+        return set;
+    }
+
+    template<implementation Impl, typename T>
+    static bool run(const dataset<T>& set) {
+        auto p = [&set](const T& x) { return x == set.needle; };
+        if constexpr (Impl == implementation::py_algo) {
+            return py_algo::all_of(set.data.begin(), set.data.end(), p);
+        } else if constexpr (Impl == implementation::std_algo) {
+            return std::all_of(set.data.begin(), set.data.end(), p);
+        } else if constexpr (Impl == implementation::std_ranges) {
+            return std::ranges::all_of(set.data, p);
+        } else {
+            for (std::size_t i = 0; i < set.data.size(); ++i) {
+                if (!p(set.data[i]))
+                    return false;
+            }
+            return true;
+        }
+    }
+};
+
+// any_of and none_of: a single element equals the needle
+
+template<typename T>
+dataset<T> make_single_match(std::size_t size, exit_point exit) {
+    dataset<T> set{std::vector<T>(size, make_value<T>(1)), make_value<T>(2)};
+    set.data[exit == exit_point::early ? early_position(size) : size - 1] = make_value<T>(2);
+    return set;
+}
+
+struct any_of_case {
+    static constexpr const char* name = "any_of";
+
+    template<typename T>
+    static dataset<T> make(std::size_t size, exit_point exit) {
+        return make_single_match<T>(size, exit);
+    }
+
+    template<implementation Impl, typename T>
+    static bool run(const dataset<T>& set) {
+        auto p = [&set](const T& x) { return x == set.needle; };
+        if constexpr (Impl == implementation::py_algo) {
+            return py_algo::any_of(set.data.begin(), set.data.end(), p);
+        } else if constexpr (Impl == implementation::std_algo) {
+            return std::any_of(set.data.begin(), set.data.end(), p);
+        } else if constexpr (Impl == implementation::std_ranges) {
+            return std::ranges::any_of(set.data, p);
+        } else {
+            for (std::size_t i = 0; i < set.data.size(); ++i) {
+                if (p(set.data[i]))
+                    return true;
+            }
+            return false;
+        }
+    }
+};
+
+struct none_of_case {
+    static constexpr const char* name = "none_of";
+
+    template<typename T>
+    static dataset<T> make(std::size_t size, exit_point exit) {
+        return make_single_match<T>(size, exit);
+    }
+
+    template<implementation Impl, typename T>
+    static bool run(const dataset<T>& set) {
+        auto p = [&set](const T& x) { return x == set.needle; };
+        if constexpr (Impl == implementation::py_algo) {
+            return py_algo::none_of(set.data.begin(), set.data.end(), p);
+        } else if constexpr (Impl == implementation::std_algo) {
+            return std::none_of(set.data.begin(), set.data.end(), p);
+        } else if constexpr (Impl == implementation::std_ranges) {
+            return std::ranges::none_of(set.data, p);
+        } else {
+            for (std::size_t i = 0; i < set.data.size(); ++i) {
+                if (p(set.data[i]))
+                    return false;
+            }
+            return true;
+        }
+    }
+};
+
+// one_of: early data has a second match right after the first one, late data has one match at the end
+
+struct one_of_case {
+    static constexpr const char* name = "one_of";
+
+    template<typename T>
+    static dataset<T> make(std::size_t size, exit_point exit) {
+        dataset<T> set = make_single_match<T>(size, exit);
+        if (exit == exit_point::early)
+            set.data[early_position(size) + 1] = set.needle;
+        return set;
+    }
+
+    template<implementation Impl, typename T>
+    static bool run(const dataset<T>& set) {
+        auto p = [&set](const T& x) { return x == set.needle; };
+        if constexpr (Impl == implementation::py_algo) {
+            return py_algo::one_of(set.data.begin(), set.data.end(), p);
+        } else if constexpr (Impl == implementation::std_algo) {
+            auto found = std::find_if(set.data.begin(), set.data.end(), p);
+            return found != set.data.end() && std::find_if(std::next(found), set.data.end(), p) == set.data.end();
+        } else if constexpr (Impl == implementation::std_ranges) {
+            auto found = std::ranges::find_if(set.data, p);
+            return found != set.data.end() &&
+                   std::ranges::find_if(std::next(found), set.data.end(), p) == set.data.end();
+        } else {
+            bool one_found = false;
+            for (std::size_t i = 0; i < set.data.size(); ++i) {
+                if (p(set.data[i])) {
+                    if (one_found)
+                        return false;
+                    one_found = true;
+                }
+            }
+            return one_found;
+        }
+    }
+};
+
+// quantify: the four quantifiers of one predicate, fused by py_algo and the loop and as
+// separate calls for std and std::ranges. Every variant has to scan the whole range.
+
+struct quantify_case {
+    static constexpr const char* name = "quantify";
+
+    template<typename T>
+    static dataset<T> make(std::size_t size, exit_point exit) {
+        return make_single_match<T>(size, exit);
+    }
+
+    template<implementation Impl, typename T>
+    static bool run(const dataset<T>& set) {
+        auto p = [&set](const T& x) { return x == set.needle; };
+        if constexpr (Impl == implementation::py_algo) {
+            auto stats = py_algo::quantify(set.data.begin(), set.data.end(), p);
+            return stats.all_of() + stats.any_of() + stats.none_of() + stats.one_of() == 2;
+        } else if constexpr (Impl == implementation::std_algo) {
+            auto one = std::count_if(set.data.begin(), set.data.end(), p) == 1;
+            return std::all_of(set.data.begin(), set.data.end(), p) + std::any_of(set.data.begin(), set.data.end(), p) +
+                   std::none_of(set.data.begin(), set.data.end(), p) + one == 2;
+        } else if constexpr (Impl == implementation::std_ranges) {
+            auto one = std::ranges::count_if(set.data, p) == 1;
+            return std::ranges::all_of(set.data, p) + std::ranges::any_of(set.data, p) +
+                   std::ranges::none_of(set.data, p) + one == 2;
+        } else {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < set.data.size(); ++i)
+                count += p(set.data[i]);
+            return (count == set.data.size()) + (count != 0) + (count == 0) + (count == 1) == 2;
+        }
+    }
+};
+
+// is_sorted: non-decreasing data with one element too large
+
+struct is_sorted_case {
+    static constexpr const char* name = "is_sorted";
+
+    template<typename T>
+    static dataset<T> make(std::size_t size, exit_point exit) {
+        dataset<T> set{std::vector<T>(size), make_value<T>(0)};
+        for (std::size_t i = 0; i < size; ++i)
+            set.data[i] = make_value<T>(static_cast<int>(i * 100 / size));
+        set.data[exit == exit_point::early ? early_position(size) : size - 2] = make_value<T>(101);
+        return set;
+    }
+
+    template<implementation Impl, typename T>
+    static bool run(const dataset<T>& set) {
+        if constexpr (Impl == implementation::py_algo) {
+            return py_algo::is_sorted(set.data.begin(), set.data.end());
+        } else if constexpr (Impl == implementation::std_algo) {
+            return std::is_sorted(set.data.begin(), set.data.end());
+        } else if constexpr (Impl == implementation::std_ranges) {
+            return std::ranges::is_sorted(set.data);
+        } else {
+            for (std::size_t i = 1; i < set.data.size(); ++i) {
+                if (set.data[i] < set.data[i - 1])
+                    return false;
+            }
+            return true;
+        }
+    }
+};
+
+// is_partitioned: matches up to a boundary; early data has one more match right after it
+
+struct is_partitioned_case {
+    static constexpr const char* name = "is_partitioned";
+
+    template<typename T>
+    static dataset<T> make(std::size_t size, exit_point exit) {
+        dataset<T> set{std::vector<T>(size, make_value<T>(100)), make_value<T>(50)};
+        std::size_t boundary = exit == exit_point::early ? early_position(size) : size / 2;
+        std::fill(set.data.begin(), set.data.begin() + boundary, make_value<T>(0));
+        if (exit == exit_point::early && boundary + 1 < size)
+            set.data[boundary + 1] = make_value<T>(0);
+        return set;
+    }
+
+    template<implementation Impl, typename T>
+    static bool run(const dataset<T>& set) {
+        auto p = [&set](const T& x) { return x < set.needle; };
+        if constexpr (Impl == implementation::py_algo) {
+            return py_algo::is_partitioned(set.data.begin(), set.data.end(), p);
+        } else if constexpr (Impl == implementation::std_algo) {
+            return std::is_partitioned(set.data.begin(), set.data.end(), p);
+        } else if constexpr (Impl == implementation::std_ranges) {
+            return std::ranges::is_partitioned(set.data, p);
+        } else {
+            std::size_t i = 0;
+            while (i < set.data.size() && p(set.data[i]))
+                ++i;
+            for (; i < set.data.size(); ++i) {
+                if (p(set.data[i]))
+                    return false;
+            }
+            return true;
+        }
+    }
+};
+
+// find_not: every element equals the needle except one
+
+struct find_not_case {
+    static constexpr const char* name = "find_not";
+
+    template<typename T>
+    static dataset<T> make(std::size_t size, exit_point exit) {
+        return all_of_case::make<T>(size, exit);
+    }
+
+    template<implementation Impl, typename T>
+    static std::size_t run(const dataset<T>& set) {
+        if constexpr (Impl == implementation::py_algo) {
+            return py_algo::find_not(set.data.begin(), set.data.end(), set.needle) - set.data.begin();
+        } else if constexpr (Impl == implementation::std_algo) {
+            return std::find_if(set.data.begin(), set.data.end(), [&set](const T& x) {
+                return x != set.needle;
+            }) - set.data.begin();
+        } else if constexpr (Impl == implementation::std_ranges) {
+            return std::ranges::find_if_not(set.data, [&set](const T& x) {
+                return x == set.needle;
+            }) - set.data.begin();
+        } else {
+            std::size_t i = 0;
+            while (i < set.data.size() && set.data[i] == set.needle)
+                ++i;
+            return i;
+        }
+    }
+};
+
+// find_not_any_of: the data cycles through four needles except one element
+
+struct find_not_any_of_case {
+    static constexpr const char* name = "find_not_any_of";
+
+    template<typename T>
+    static std::vector<T> needles() {
+        return {make_value<T>(1), make_value<T>(2), make_value<T>(3), make_value<T>(4)};
+    }
+
+    template<typename T>
+    static dataset<T> make(std::size_t size, exit_point exit) {
+        dataset<T> set{std::vector<T>(size), make_value<T>(5)};
+        for (std::size_t i = 0; i < size; ++i)
+            set.data[i] = make_value<T>(static_cast<int>(i % 4) + 1);
+        set.data[exit == exit_point::early ? early_position(size) : size - 1] = set.needle;
+        return set;
+    }
+
+    template<implementation Impl, typename T>
+    static std::size_t run(const dataset<T>& set) {
+        static const std::vector<T> values = needles<T>();
+        auto is_needle = [](const T& x) { return std::find(values.begin(), values.end(), x) != values.end(); };
+        if constexpr (Impl == implementation::py_algo) {
+            return py_algo::find_not_any_of(set.data.begin(), set.data.end(), values.begin(), values.end()) - set.data.begin();
+        } else if constexpr (Impl == implementation::std_algo) {
+            return std::find_if_not(set.data.begin(), set.data.end(), is_needle) - set.data.begin();
+        } else if constexpr (Impl == implementation::std_ranges) {
+            return std::ranges::find_if_not(set.data, is_needle) - set.data.begin();
+        } else {
+            std::size_t i = 0;
+            while (i < set.data.size() && (set.data[i] == values[0] || set.data[i] == values[1] ||
+                                            set.data[i] == values[2] || set.data[i] == values[3]))
+                ++i;
+            return i;
+        }
+    }
+};
+
+// find_backward: a single element equals the needle, counted from the end
+
+struct find_backward_case {
+    static constexpr const char* name = "find_backward";
+
+    template<typename T>
+    static dataset<T> make(std::size_t size, exit_point exit) {
+        dataset<T> set{std::vector<T>(size, make_value<T>(1)), make_value<T>(2)};
+        set.data[exit == exit_point::early ? size - 1 - early_position(size) : 0] = set.needle;
+        return set;
+    }
+
+    template<implementation Impl, typename T>
+    static std::size_t run(const dataset<T>& set) {
+        if constexpr (Impl == implementation::py_algo) {
+            return py_algo::find_backward(set.data.begin(), set.data.end(), set.needle) - set.data.begin();
+        } else if constexpr (Impl == implementation::std_algo) {
+            auto found = std::find(set.data.rbegin(), set.data.rend(), set.needle);
+            return found == set.data.rend() ? set.data.size() : set.data.rend() - found - 1;
+        } else if constexpr (Impl == implementation::std_ranges) {
+            auto reversed = set.data | std::views::reverse;
+            auto found = std::ranges::find(reversed, set.needle);
+            return found == reversed.end() ? set.data.size() : reversed.end() - found - 1;
+        } else {
+            for (std::size_t i = set.data.size(); i-- > 0;) {
+                if (set.data[i] == set.needle)
+                    return i;
+            }
+            return set.data.size();
+        }
+    }
+};
+
+// is_palindrome: a palindrome whose early data breaks symmetry near both ends
+
+struct is_palindrome_case {
+    static constexpr const char* name = "is_palindrome";
+
+    template<typename T>
+    static dataset<T> make(std::size_t size, exit_point exit) {
+        dataset<T> set{std::vector<T>(size), make_value<T>(0)};
+        for (std::size_t i = 0; i < size; ++i)
+            set.data[i] = make_value<T>(static_cast<int>(std::min(i, size - 1 - i) % 100));
+        if (exit == exit_point::early)
+            set.data[early_position(size)] = make_value<T>(101);
+        return set;
+    }
+
+    template<implementation Impl, typename T>
+    static bool run(const dataset<T>& set) {
+        std::size_t half = set.data.size() / 2;
+        if constexpr (Impl == implementation::py_algo) {
+            return py_algo::is_palindrome(set.data.begin(), set.data.end());
+        } else if constexpr (Impl == implementation::std_algo) {
+            return std::equal(set.data.begin(), set.data.begin() + half, set.data.rbegin());
+        } else if constexpr (Impl == implementation::std_ranges) {
+            return std::ranges::equal(set.data | std::views::take(half),
+                                      set.data | std::views::reverse | std::views::take(half));
+        } else {
+            for (std::size_t i = 0; i < half; ++i) {
+                if (set.data[i] != set.data[set.data.size() - 1 - i])
+                    return false;
+            }
+            return true;
+        }
+    }
+};
+
+template<typename Case, implementation Impl, typename T>
+void run_case(benchmark::State& state) {
+    auto size = static_cast<std::size_t>(state.range(0));
+    auto set = Case::template make<T>(size, static_cast<exit_point>(state.range(1)));
+    for (auto _: state)
+        benchmark::DoNotOptimize(Case::template run<Impl>(set));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size * sizeof(T)));
+}
+
+// Buffer sizes meant to sit in L1, L2, last level cache and DRAM
+constexpr std::size_t buffer_bytes[] = {std::size_t(4) << 10, std::size_t(256) << 10,
+                                        std::size_t(8) << 20, std::size_t(128) << 20};
+
+template<typename Case, implementation Impl, typename T>
+void register_case() {
+    std::string name = std::string(Case::name) + "<" + type_name<T>() + ">/" + implementation_name(Impl);
+    auto bench = benchmark::RegisterBenchmark(name.c_str(), run_case<Case, Impl, T>);
+    bench->ArgNames({"n", "late"});
+    for (auto bytes: buffer_bytes) {
+        for (auto exit: {exit_point::early, exit_point::late})
+            bench->Args({static_cast<std::int64_t>(bytes / sizeof(T)), static_cast<std::int64_t>(exit)});
+    }
+}
+
+template<typename Case, typename T>
+void register_implementations() {
+    register_case<Case, implementation::py_algo, T>();
+    register_case<Case, implementation::std_algo, T>();
+    register_case<Case, implementation::std_ranges, T>();
+    register_case<Case, implementation::raw_loop, T>();
+}
+
+template<typename Case>
+void register_types() {
+    register_implementations<Case, std::int8_t>();
+    register_implementations<Case, std::int16_t>();
+    register_implementations<Case, std::int32_t>();
+    register_implementations<Case, std::int64_t>();
+    register_implementations<Case, float>();
+    register_implementations<Case, double>();
+    register_implementations<Case, std::string>();
+}
+
+// xrange iteration against a counted loop and std::views::iota
+
+template<typename T>
+void BM_XrangeSum(benchmark::State& state) {
+    auto range = py_algo::xrange<T>(T(0), static_cast<T>(state.range(0)));
+    for (auto _: state) {
+        T total = T();
+        for (auto x: range)
+            total += x;
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename T>
+void BM_XrangeSumLoop(benchmark::State& state) {
+    auto size = static_cast<T>(state.range(0));
+    for (auto _: state) {
+        T total = T();
+        for (T x = T(0); x < size; x += T(1))
+            total += x;
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_XrangeSumIota(benchmark::State& state) {
+    for (auto _: state) {
+        std::int64_t total = 0;
+        for (auto x: std::views::iota(std::int64_t(0), static_cast<std::int64_t>(state.range(0))))
+            total += x;
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_XrangeSum<std::int64_t>)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_XrangeSumLoop<std::int64_t>)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_XrangeSumIota)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_XrangeSum<double>)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_XrangeSumLoop<double>)->Range(1 << 10, 1 << 24);
+
+// Materializing a float range: xrange::fill against writing the iterated values
+
+template<typename T>
+void BM_XrangeFill(benchmark::State& state) {
+    auto range = py_algo::xrange<T>(T(0), static_cast<T>(state.range(0)) * T(0.25), T(0.25));
+    std::vector<T> out(range.size());
+    for (auto _: state) {
+        range.fill(out.begin());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(out.size() * sizeof(T)));
+}
+
+template<typename T>
+void BM_XrangeFillLoop(benchmark::State& state) {
+    auto range = py_algo::xrange<T>(T(0), static_cast<T>(state.range(0)) * T(0.25), T(0.25));
+    std::vector<T> out(range.size());
+    for (auto _: state) {
+        std::copy(range.begin(), range.end(), out.begin());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(out.size() * sizeof(T)));
+}
+
+BENCHMARK(BM_XrangeFill<double>)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_XrangeFillLoop<double>)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_XrangeFill<float>)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_XrangeFillLoop<float>)->Range(1 << 10, 1 << 22);
+
+// A filter | transform pipeline over xrange against the loop it should fuse into
+
+void BM_Pipeline(benchmark::State& state) {
+    auto squares = py_algo::xrange<std::int64_t>(0, state.range(0))
+                   | py_algo::views::filter([](std::int64_t x) { return x % 3 != 0; })
+                   | py_algo::views::transform([](std::int64_t x) { return x * x; });
+    for (auto _: state) {
+        std::int64_t total = 0;
+        for (auto x: squares)
+            total += x;
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_PipelineLoop(benchmark::State& state) {
+    auto size = static_cast<std::int64_t>(state.range(0));
+    for (auto _: state) {
+        std::int64_t total = 0;
+        for (std::int64_t x = 0; x < size; ++x) {
+            if (x % 3 != 0)
+                total += x * x;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// What chaining looked like without views: a vector per stage
+void BM_PipelineMaterialized(benchmark::State& state) {
+    for (auto _: state) {
+        auto range = py_algo::xrange<std::int64_t>(0, state.range(0));
+        std::vector<std::int64_t> filtered;
+        std::copy_if(range.begin(), range.end(), std::back_inserter(filtered), [](std::int64_t x) { return x % 3 != 0; });
+        std::vector<std::int64_t> squares(filtered.size());
+        std::transform(filtered.begin(), filtered.end(), squares.begin(), [](std::int64_t x) { return x * x; });
+        benchmark::DoNotOptimize(std::accumulate(squares.begin(), squares.end(), std::int64_t(0)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Pipeline)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_PipelineLoop)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_PipelineMaterialized)->Range(1 << 10, 1 << 20);
+
+// zip iteration. Strings are longer than the small string buffer, so each copy allocates
+
+std::pair<std::vector<int>, std::vector<std::string>> make_columns(std::size_t size) {
+    return {std::vector<int>(size, 1), std::vector<std::string>(size, std::string(48, 'x'))};
+}
+
+// What the two-container zip did before it yielded references: a pair of copies per step
+void BM_ZipPairCopy(benchmark::State& state) {
+    auto [keys, names] = make_columns(state.range(0));
+    for (auto _: state) {
+        std::size_t total = 0;
+        auto key = keys.cbegin();
+        auto name = names.cbegin();
+        for (; key != keys.cend() && name != names.cend(); ++key, ++name) {
+            std::pair<const int, const std::string> value = std::make_pair(*key, *name);
+            total += value.first + value.second.size();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Zip(benchmark::State& state) {
+    auto [keys, names] = make_columns(state.range(0));
+    for (auto _: state) {
+        std::size_t total = 0;
+        for (auto [key, name]: py_algo::zip(keys, names))
+            total += key + name.size();
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ZipLoop(benchmark::State& state) {
+    auto [keys, names] = make_columns(state.range(0));
+    for (auto _: state) {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < keys.size() && i < names.size(); ++i)
+            total += keys[i] + names[i].size();
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ZipPairCopy)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Zip)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_ZipLoop)->Range(1 << 10, 1 << 20);
+
+// End checks of zip and xrange loops. A counted zip compares its position only, through
+// end() or end_sentinel(); BM_ZipEndEveryIterator is the check it replaced, one comparison
+// per container, which also keeps the compiler from vectorizing the loop.
+
+std::pair<std::vector<std::int32_t>, std::vector<std::int32_t>> make_int_columns(std::size_t size) {
+    return {std::vector<std::int32_t>(size, 2), std::vector<std::int32_t>(size, 3)};
+}
+
+void BM_ZipEnd(benchmark::State& state) {
+    auto [left, right] = make_int_columns(state.range(0));
+    py_algo::zip columns(left, right);
+    for (auto _: state) {
+        std::int64_t total = 0;
+        for (auto iter = columns.begin(), last = columns.end(); iter != last; ++iter)
+            total += std::get<0>(*iter) * std::get<1>(*iter);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ZipEndSentinel(benchmark::State& state) {
+    auto [left, right] = make_int_columns(state.range(0));
+    py_algo::zip columns(left, right);
+    for (auto _: state) {
+        std::int64_t total = 0;
+        auto last = columns.end_sentinel();
+        for (auto iter = columns.begin(); iter != last; ++iter)
+            total += std::get<0>(*iter) * std::get<1>(*iter);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ZipEndEveryIterator(benchmark::State& state) {
+    auto [left, right] = make_int_columns(state.range(0));
+    py_algo::zip columns(left, right);
+    for (auto _: state) {
+        std::int64_t total = 0;
+        auto last = columns.end();
+        for (auto iter = columns.begin(); std::get<0>(iter.base()) != std::get<0>(last.base()) &&
+                                          std::get<1>(iter.base()) != std::get<1>(last.base()); ++iter)
+            total += std::get<0>(*iter) * std::get<1>(*iter);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ZipEndLoop(benchmark::State& state) {
+    auto [left, right] = make_int_columns(state.range(0));
+    for (auto _: state) {
+        std::int64_t total = 0;
+        for (std::size_t i = 0; i < left.size(); ++i)
+            total += left[i] * right[i];
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ZipEnd)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_ZipEndSentinel)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_ZipEndEveryIterator)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_ZipEndLoop)->Range(1 << 10, 1 << 20);
+
+// Joins a list and a vector into rows, growing the output as it goes (reserve = 0) or
+// reserving zip::size() rows up front (reserve = 1)
+void BM_ZipCollect(benchmark::State& state) {
+    auto size = static_cast<std::size_t>(state.range(0));
+    std::list<std::int32_t> left(size, 2);
+    std::vector<std::int64_t> right(size, 3);
+    py_algo::zip columns(left, right);
+    for (auto _: state) {
+        std::vector<std::pair<std::int32_t, std::int64_t>> rows;
+        if (state.range(1))
+            rows.reserve(columns.size());
+        for (auto [l, r]: columns)
+            rows.emplace_back(l, r);
+        benchmark::DoNotOptimize(rows.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ZipCollect)->ArgsProduct({{1 << 10, 1 << 16, 1 << 20}, {0, 1}});
+
+// none_of, one_of and is_partitioned per branch mode over a sweep of predicate selectivity.
+// Values are uniform in [0, 100) and the predicate is x < selectivity; none_of and one_of see
+// them shuffled and stop at the first or second match, is_partitioned sees them sorted and
+// scans to the end.
+
+std::vector<std::int32_t> make_percentiles(std::size_t size, bool sorted) {
+    std::vector<std::int32_t> data(size);
+    std::mt19937 engine(42);
+    std::uniform_int_distribution<std::int32_t> percent(0, 99);
+    for (auto& x: data)
+        x = percent(engine);
+    if (sorted)
+        std::sort(data.begin(), data.end());
+    return data;
+}
+
+struct none_of_sweep {
+    static constexpr bool sorted = false;
+
+    template<typename UnaryPredicate>
+    static bool run(py_algo::branch_mode mode, const std::vector<std::int32_t>& data, UnaryPredicate p) {
+        return py_algo::none_of(mode, data.begin(), data.end(), p);
+    }
+};
+
+struct one_of_sweep {
+    static constexpr bool sorted = false;
+
+    template<typename UnaryPredicate>
+    static bool run(py_algo::branch_mode mode, const std::vector<std::int32_t>& data, UnaryPredicate p) {
+        return py_algo::one_of(mode, data.begin(), data.end(), p);
+    }
+};
+
+struct is_partitioned_sweep {
+    static constexpr bool sorted = true;
+
+    template<typename UnaryPredicate>
+    static bool run(py_algo::branch_mode mode, const std::vector<std::int32_t>& data, UnaryPredicate p) {
+        return py_algo::is_partitioned(mode, data.begin(), data.end(), p);
+    }
+};
+
+template<typename Sweep>
+void BM_BranchSweep(benchmark::State& state) {
+    auto data = make_percentiles(1 << 16, Sweep::sorted);
+    auto mode = static_cast<py_algo::branch_mode>(state.range(0));
+    auto selectivity = static_cast<std::int32_t>(state.range(1));
+    for (auto _: state)
+        benchmark::DoNotOptimize(Sweep::run(mode, data, [selectivity](std::int32_t x) { return x < selectivity; }));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(data.size()));
+}
+
+void branch_sweep_args(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"mode", "selectivity"});
+    for (std::int64_t mode: {0, 1, 2}) {
+        for (std::int64_t selectivity: {0, 1, 2, 5, 10, 25, 50, 75, 90, 99, 100})
+            bench->Args({mode, selectivity});
+    }
+}
+
+BENCHMARK(BM_BranchSweep<none_of_sweep>)->Apply(branch_sweep_args);
+BENCHMARK(BM_BranchSweep<one_of_sweep>)->Apply(branch_sweep_args);
+BENCHMARK(BM_BranchSweep<is_partitioned_sweep>)->Apply(branch_sweep_args);
+
+// Two-column reductions: a fold over zip rows (mode 0), the vector kernels of
+// zip_transform_reduce (1), the same in deterministic order (2) and in parallel (3)
+
+template<typename T, typename Compare>
+T reduce_columns(int mode, const std::vector<T>& a, const std::vector<T>& b, Compare compare) {
+    py_algo::zip columns(a, b);
+    switch (mode) {
+        case 0:
+            return py_algo::zip_reduce(columns, T(), [&compare](T acc, const auto& row) {
+                return acc + compare(std::get<0>(row), std::get<1>(row));
+            });
+        case 1:
+            return py_algo::zip_transform_reduce(columns, T(), std::plus<>(), compare);
+        case 2:
+            return py_algo::zip_transform_reduce(columns, T(), std::plus<>(), compare,
+                                                 py_algo::reduction_order::deterministic);
+        default:
+            return py_algo::zip_transform_reduce(py_algo::execution::par, columns, T(), std::plus<>(), compare);
+    }
+}
+
+void BM_ZipDot(benchmark::State& state) {
+    std::vector<float> a(state.range(0), 0.5f), b(state.range(0), 2.0f);
+    for (auto _: state)
+        benchmark::DoNotOptimize(reduce_columns(static_cast<int>(state.range(1)), a, b, std::multiplies<>()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ZipCountLess(benchmark::State& state) {
+    auto a = make_percentiles(state.range(0), false);
+    auto b = make_percentiles(state.range(0), true);
+    for (auto _: state)
+        benchmark::DoNotOptimize(reduce_columns(static_cast<int>(state.range(1)), a, b, std::less<>()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ZipDot)->ArgsProduct({{1 << 10, 1 << 16, 1 << 20}, {0, 1, 2, 3}});
+BENCHMARK(BM_ZipCountLess)->ArgsProduct({{1 << 10, 1 << 16, 1 << 20}, {0, 1, 2, 3}});
+
+// Index + element loops: a plain index loop (mode 0), enumerate (1), zip with an xrange of
+// indices (2) and parallel_for_each_indexed (3), each writing x[i] += i
+
+void BM_Enumerate(benchmark::State& state) {
+    std::vector<std::int64_t> data(state.range(0), 1);
+    py_algo::xrange<std::size_t> indices(data.size());
+    for (auto _: state) {
+        switch (state.range(1)) {
+            case 0:
+                for (std::size_t i = 0; i < data.size(); ++i)
+                    data[i] += static_cast<std::int64_t>(i);
+                break;
+            case 1:
+                for (auto [i, x]: py_algo::enumerate(data))
+                    x += static_cast<std::int64_t>(i);
+                break;
+            case 2:
+                for (auto [i, x]: py_algo::zip(indices, data))
+                    x += static_cast<std::int64_t>(i);
+                break;
+            default:
+                py_algo::parallel_for_each_indexed(data, [](std::size_t i, std::int64_t& x) {
+                    x += static_cast<std::int64_t>(i);
+                });
+        }
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Enumerate)->ArgsProduct({{1 << 10, 1 << 16, 1 << 20}, {0, 1, 2, 3}});
+
+// find_not and find_backward from random offsets of a sparse frame, one sample every 16K
+// zeros, scanning (mode 0) or answered from a run_index (mode 1). BM_RunIndexUpdate is the
+// cost of keeping the index current after a point write.
+
+std::vector<std::int32_t> make_sparse_frame(std::size_t size) {
+    std::vector<std::int32_t> frame(size, 0);
+    for (std::size_t i = 1 << 14; i < size; i += 1 << 14)
+        frame[i] = static_cast<std::int32_t>(i);
+    return frame;
+}
+
+void BM_RunIndexQuery(benchmark::State& state) {
+    auto frame = make_sparse_frame(state.range(0));
+    py_algo::run_index index(frame.begin(), frame.end());
+    std::mt19937 engine(1);
+    for (auto _: state) {
+        auto first = frame.begin() + static_cast<std::ptrdiff_t>(engine() % frame.size());
+        if (state.range(1)) {
+            benchmark::DoNotOptimize(py_algo::find_not(index, first, frame.end(), 0));
+            benchmark::DoNotOptimize(py_algo::find_backward(index, frame.begin(), first, 1 << 14));
+        } else {
+            benchmark::DoNotOptimize(py_algo::find_not(first, frame.end(), 0));
+            benchmark::DoNotOptimize(py_algo::find_backward(frame.begin(), first, 1 << 14));
+        }
+    }
+    state.counters["runs"] = static_cast<double>(index.runs());
+    state.counters["index_bytes"] = static_cast<double>(index.memory_usage());
+}
+
+void BM_RunIndexUpdate(benchmark::State& state) {
+    auto frame = make_sparse_frame(state.range(0));
+    py_algo::run_index index(frame.begin(), frame.end());
+    std::mt19937 engine(1);
+    for (auto _: state) {
+        auto pos = frame.begin() + static_cast<std::ptrdiff_t>(engine() % frame.size());
+        auto old = *pos;
+        *pos = 1;
+        index.update(pos);
+        *pos = old;
+        index.update(pos);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK(BM_RunIndexQuery)->ArgsProduct({{1 << 16, 1 << 20, 1 << 24}, {0, 1}});
+BENCHMARK(BM_RunIndexUpdate)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 24);
+
+int main(int argc, char** argv) {
+    register_types<all_of_case>();
+    register_types<any_of_case>();
+    register_types<none_of_case>();
+    register_types<one_of_case>();
+    register_types<quantify_case>();
+    register_types<is_sorted_case>();
+    register_types<is_partitioned_case>();
+    register_types<find_not_case>();
+    register_types<find_not_any_of_case>();
+    register_types<find_backward_case>();
+    register_types<is_palindrome_case>();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+#define PY_ALGO_INSTRUMENT
+
+#include "algo/py_algo.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+TEST(InstrumentTestSuit, PredicateCountersTest) {
+    auto& registry = py_algo::call_registry::local();
+    registry.clear();
+
+    std::vector<int> v = {2, 4, 6, 7, 8, 10};
+    ASSERT_FALSE(py_algo::all_of(v.begin(), v.end(), [](int a) { return a % 2 == 0; }));
+    ASSERT_TRUE(py_algo::none_of(v.begin(), v.end(), [](int a) { return a > 10; }));
+
+    std::list<int> l(v.begin(), v.end());
+    ASSERT_FALSE(py_algo::one_of(l.begin(), l.end(), [](int a) { return a > 5; }));
+
+    ASSERT_EQ(3, registry.records().size());
+    const auto& all = registry.records()[0];
+    ASSERT_STREQ("all_of", all.algorithm);
+    ASSERT_EQ(py_algo::call_kernel::scalar, all.kernel);
+    ASSERT_EQ(6, all.size);
+    ASSERT_EQ(4, all.visited);
+    ASSERT_EQ(4, all.predicate_calls);
+    ASSERT_EQ(3, all.exit_position);
+    ASSERT_TRUE(all.early_exit);
+
+    const auto& none = registry.records()[1];
+    ASSERT_EQ(6, none.visited);
+    ASSERT_EQ(-1, none.exit_position);
+    ASSERT_FALSE(none.early_exit);
+
+    const auto& one = registry.records()[2];
+    ASSERT_EQ(-1, one.size);
+    ASSERT_EQ(4, one.predicate_calls);
+    ASSERT_EQ(3, one.exit_position);
+}
+
+TEST(InstrumentTestSuit, KernelsTest) {
+    auto& registry = py_algo::call_registry::local();
+    registry.clear();
+
+    std::vector<int> v(100000, 1);
+    v[70000] = 2;
+    ASSERT_EQ(v.begin() + 70000, py_algo::find_not(v.begin(), v.end(), 1));
+    ASSERT_EQ(v.begin() + 70000, py_algo::find_backward(v.begin(), v.end(), 2));
+    ASSERT_EQ(v.begin() + 70000, py_algo::find_not(py_algo::execution::par, v.begin(), v.end(), 1));
+    ASSERT_TRUE(py_algo::any_of(py_algo::execution::par, v.begin(), v.end(), [](int a) { return a == 2; }));
+
+    // The sequential blocks of the parallel find_not are not recorded on their own
+    ASSERT_EQ(4, registry.records().size());
+    auto find = registry.records()[0];
+    ASSERT_EQ(py_algo::call_kernel::simd, find.kernel);
+    ASSERT_EQ(70001, find.visited);
+    ASSERT_EQ(70000, find.exit_position);
+    ASSERT_EQ(0, find.predicate_calls);
+
+    auto backward = registry.records()[1];
+    ASSERT_EQ(30000, backward.visited);
+    ASSERT_EQ(70000, backward.exit_position);
+
+    auto parallel_find = registry.records()[2];
+    ASSERT_EQ(py_algo::call_kernel::parallel, parallel_find.kernel);
+    ASSERT_EQ(70000, parallel_find.exit_position);
+    ASSERT_GT(parallel_find.visited, 70000);
+
+    auto any = registry.records()[3];
+    ASSERT_EQ(py_algo::call_kernel::parallel, any.kernel);
+    ASSERT_TRUE(any.early_exit);
+    ASSERT_EQ(any.visited, any.predicate_calls);
+    ASSERT_LE(any.visited, v.size());
+
+    // An int needle on a byte buffer is narrowed for the kernel, one out of range answers at once
+    registry.clear();
+    std::vector<std::uint8_t> bytes(1000, 0);
+    bytes[600] = 7;
+    ASSERT_EQ(bytes.begin() + 600, py_algo::find_not(bytes.begin(), bytes.end(), 0));
+    ASSERT_EQ(bytes.end(), py_algo::find_backward(bytes.begin(), bytes.end(), 256));
+    ASSERT_EQ(2, registry.records().size());
+    ASSERT_EQ(py_algo::call_kernel::simd, registry.records()[0].kernel);
+    ASSERT_EQ(0, registry.records()[1].visited);
+}
+
+TEST(InstrumentTestSuit, BranchModesTest) {
+    auto& registry = py_algo::call_registry::local();
+    registry.clear();
+
+    std::vector<int> v(1000, 0);
+    v[10] = 1;
+    v[20] = 1;
+    auto is_one = [](int a) { return a == 1; };
+    ASSERT_FALSE(py_algo::one_of(py_algo::branch_mode::branchy, v.begin(), v.end(), is_one));
+    ASSERT_FALSE(py_algo::one_of(py_algo::branch_mode::branchless, v.begin(), v.end(), is_one));
+    ASSERT_FALSE(py_algo::one_of(py_algo::branch_mode::adaptive, v.begin(), v.end(), is_one));
+    v[20] = 0;
+    ASSERT_FALSE(py_algo::none_of(py_algo::branch_mode::adaptive, v.begin(), v.end(), is_one));
+
+    ASSERT_EQ(4, registry.records().size());
+    ASSERT_EQ(20, registry.records()[0].exit_position);
+    ASSERT_EQ(21, registry.records()[0].predicate_calls);
+    // Branchless scans finish the block holding the answer and do not know its position
+    ASSERT_EQ(256, registry.records()[1].predicate_calls);
+    ASSERT_EQ(-1, registry.records()[1].exit_position);
+    ASSERT_TRUE(registry.records()[1].early_exit);
+    ASSERT_EQ(64, registry.records()[2].predicate_calls);
+    ASSERT_EQ(64, registry.records()[3].predicate_calls);
+}
+
+TEST(InstrumentTestSuit, DumpTest) {
+    auto& registry = py_algo::call_registry::local();
+    registry.clear();
+    registry.set_limit(1);
+
+    std::size_t seen = 0;
+    registry.set_callback([&seen](const py_algo::call_record&) { ++seen; });
+    std::vector<int> v = {1, 2, 3};
+    py_algo::any_of(v.begin(), v.end(), [](int a) { return a == 2; });
+    py_algo::all_of(v.begin(), v.end(), [](int a) { return a > 0; });
+    registry.set_callback(nullptr);
+
+    ASSERT_EQ(2, seen);
+    ASSERT_EQ(1, registry.records().size());
+    ASSERT_EQ(1, registry.dropped());
+
+    auto json = registry.to_json();
+    auto expected_prefix = std::string("{\"dropped\": 1, \"calls\": [{\"algorithm\": \"any_of\", \"kernel\": \"scalar\", "
+                                       "\"size\": 3, \"visited\": 2, \"predicate_calls\": 2, \"exit_position\": 1, "
+                                       "\"early_exit\": true, \"elapsed_ns\": ");
+    ASSERT_EQ(expected_prefix, json.substr(0, expected_prefix.size()));
+    ASSERT_EQ("}]}", json.substr(json.size() - 3));
+
+    std::size_t dumped = 0;
+    registry.dump([&dumped](const py_algo::call_record& _record) { dumped += _record.visited; });
+    ASSERT_EQ(2, dumped);
+
+    registry.set_limit(4096);
+    registry.clear();
+}
+
+TEST(InstrumentTestSuit, ConstantEvaluationTest) {
+    static_assert(py_algo::all_of(std::string_view("aaa").begin(), std::string_view("aaa").end(), [](char c) { return c == 'a'; }));
+    static_assert(py_algo::find_not(std::string_view("aab").begin(), std::string_view("aab").end(), 'a') == std::string_view("aab").begin() + 2);
+}
@@ -1,6 +1,30 @@
 #include "algo/py_algo.h"
+#include "algo/py_algo_mmap.h"
+#include "algo/py_algo_ranges.h"
+#include "algo/py_algo_run_index.h"
+#include "algo/py_algo_views.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <forward_list>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
 #include <vector>
 
 
@@ -43,6 +67,84 @@ TEST(AlgoTestSuit, OneOfTest) {
     ASSERT_FALSE(py_algo::one_of(v2.begin(), v2.end(), [](int a) { return a == 0; }));
 }
 
+TEST(AlgoTestSuit, QuantifyTest) {
+    std::vector<int> v = {4, 1, 6, 3, 8, 5};
+    auto stats = py_algo::quantify(v.begin(), v.end(), [](int a) { return a % 2 == 1; });
+    ASSERT_EQ(3, stats.count);
+    ASSERT_EQ(v.begin() + 1, stats.first_match);
+    ASSERT_EQ(v.begin() + 5, stats.last_match);
+    ASSERT_FALSE(stats.all_of());
+    ASSERT_TRUE(stats.any_of());
+    ASSERT_FALSE(stats.none_of());
+    ASSERT_FALSE(stats.one_of());
+
+    std::list<int> l = {2, 4, 7, 8};
+    auto stats2 = py_algo::quantify(l.begin(), l.end(), [](int a) { return a % 2 == 1; });
+    ASSERT_TRUE(stats2.one_of());
+    ASSERT_EQ(7, *stats2.first_match);
+    ASSERT_EQ(stats2.first_match, stats2.last_match);
+
+    std::vector<int> v2 = {};
+    auto stats3 = py_algo::quantify(v2.begin(), v2.end(), [](int a) { return a > 0; });
+    ASSERT_TRUE(stats3.all_of());
+    ASSERT_TRUE(stats3.none_of());
+    ASSERT_EQ(v2.end(), stats3.first_match);
+
+    std::vector<int> v3(10000, 1);
+    v3[10] = 0;
+    std::size_t calls = 0;
+    auto counted = [&calls](int a) {
+        ++calls;
+        return a == 1;
+    };
+    auto stats4 = py_algo::quantify(v3.begin(), v3.end(), counted, py_algo::quantifier::all_of | py_algo::quantifier::one_of);
+    ASSERT_FALSE(stats4.all_of());
+    ASSERT_FALSE(stats4.one_of());
+    ASSERT_LT(calls, v3.size());
+
+    calls = 0;
+    std::forward_list<int> f(v3.begin(), v3.end());
+    ASSERT_TRUE(py_algo::quantify(f.begin(), f.end(), counted, py_algo::quantifier::any_of).any_of());
+    ASSERT_EQ(1, calls);
+}
+
+TEST(AlgoTestSuit, BranchModesTest) {
+    const py_algo::branch_mode modes[] = {py_algo::branch_mode::branchy, py_algo::branch_mode::branchless,
+                                          py_algo::branch_mode::adaptive};
+    auto is_one = [](int a) { return a == 1; };
+    // Matches around the sample and block ends of the branchless kernels
+    for (std::size_t size: {0, 1, 63, 64, 65, 255, 256, 257, 700}) {
+        for (std::size_t first: {0, 1, 62, 63, 64, 255, 256, 500}) {
+            for (std::size_t second: {1, 63, 64, 65, 256, 257, 699}) {
+                std::vector<int> v(size, 0);
+                if (first < size)
+                    v[first] = 1;
+                if (second > first && second < size)
+                    v[second] = 1;
+                std::forward_list<int> list(v.begin(), v.end());
+                // Ones up to first, zeros after it, and a one at second
+                std::vector<int> parts(size, 0);
+                std::fill(parts.begin(), parts.begin() + static_cast<std::ptrdiff_t>(std::min(first, size)), 1);
+                if (second > first && second < size)
+                    parts[second] = 1;
+
+                for (auto mode: modes) {
+                    ASSERT_EQ(py_algo::none_of(mode, v.begin(), v.end(), is_one), std::none_of(v.begin(), v.end(), is_one));
+                    ASSERT_EQ(py_algo::one_of(mode, v.begin(), v.end(), is_one), std::count(v.begin(), v.end(), 1) == 1);
+                    ASSERT_EQ(py_algo::one_of(mode, list.begin(), list.end(), is_one), std::count(v.begin(), v.end(), 1) == 1);
+                    ASSERT_EQ(py_algo::is_partitioned(mode, parts.begin(), parts.end(), is_one),
+                              std::is_partitioned(parts.begin(), parts.end(), is_one));
+                }
+            }
+        }
+    }
+
+    std::list<std::string> words = {"a", "b", "c"};
+    auto is_b = [](const std::string& a) { return a == "b"; };
+    ASSERT_TRUE(py_algo::one_of(py_algo::branch_mode::adaptive, words.begin(), words.end(), is_b));
+    ASSERT_FALSE(py_algo::is_partitioned(py_algo::branch_mode::branchless, words.begin(), words.end(), is_b));
+}
+
 TEST(AlgoTestSuit, IsSortedTest) {
     std::vector<float> v = {1.2, 2.2, 3.4, 4.5, 5.6, 6.7, 7.8, 8.9};
     ASSERT_TRUE(py_algo::is_sorted(v.begin(), v.end()));
@@ -58,6 +160,80 @@ TEST(AlgoTestSuit, IsSortedTest) {
     ASSERT_FALSE(py_algo::is_sorted(v4.begin(), v4.end()));
 }
 
+TEST(AlgoTestSuit, IsSortedUntilTest) {
+    std::vector<int> v = {1, 2, 2, 5, 4, 6, 3};
+    ASSERT_EQ(v.begin() + 4, py_algo::is_sorted_until(v.begin(), v.end()));
+    ASSERT_EQ(v.begin() + 1, py_algo::is_sorted_until(v.begin(), v.end(), std::greater<>()));
+
+    std::forward_list<int> l = {3, 2, 1, 1};
+    ASSERT_EQ(l.end(), py_algo::is_sorted_until(l.begin(), l.end(), std::greater<>()));
+    ASSERT_TRUE(py_algo::is_sorted(l.begin(), l.end(), std::greater<>()));
+    ASSERT_FALSE(py_algo::is_sorted(l.begin(), l.end()));
+
+    auto stats = py_algo::sortedness(v.begin(), v.end());
+    ASSERT_EQ(v.begin() + 4, stats.first_violation);
+    ASSERT_EQ(2, stats.descents);
+    ASSERT_EQ(3, stats.runs);
+    ASSERT_FALSE(stats.sorted());
+
+    std::vector<int> v2 = {};
+    ASSERT_EQ(0, py_algo::sortedness(v2.begin(), v2.end()).runs);
+    ASSERT_TRUE(py_algo::sortedness(v2.begin(), v2.end()).sorted());
+}
+
+template<typename T>
+void check_sorted_kernels() {
+    for (std::size_t size: {0, 1, 2, 17, 32, 33, 65, 200, 1000}) {
+        std::vector<T> v(size);
+        for (std::size_t i = 0; i < size; ++i)
+            v[i] = static_cast<T>(i * 40 / size);
+        ASSERT_EQ(v.end(), py_algo::is_sorted_until(v.begin(), v.end()));
+        ASSERT_EQ(size > 0 ? 1 : 0, py_algo::sortedness(v.begin(), v.end()).runs);
+        for (std::size_t i = 1; i < size; i += 1 + size / 13) {
+            auto saved = v[i];
+            v[i] = std::is_unsigned_v<T> ? T(0) : static_cast<T>(-1);
+            ASSERT_EQ(std::is_sorted_until(v.begin(), v.end()), py_algo::is_sorted_until(v.begin(), v.end()));
+            std::size_t descents = 0;
+            for (std::size_t j = 1; j < size; ++j)
+                descents += v[j] < v[j - 1];
+            ASSERT_EQ(descents, py_algo::sortedness(v.begin(), v.end()).descents);
+            v[i] = saved;
+        }
+    }
+}
+
+TEST(SimdTestSuit, SortedKernelsTest) {
+    check_sorted_kernels<std::int8_t>();
+    check_sorted_kernels<std::uint8_t>();
+    check_sorted_kernels<std::int16_t>();
+    check_sorted_kernels<std::uint32_t>();
+    check_sorted_kernels<std::int64_t>();
+    check_sorted_kernels<std::uint64_t>();
+    check_sorted_kernels<float>();
+    check_sorted_kernels<double>();
+
+    std::vector<std::uint32_t> v = {1, 0x80000000u, 0xFFFFFFFFu, 2};
+    ASSERT_EQ(v.begin() + 3, py_algo::is_sorted_until(v.begin(), v.end()));
+}
+
+TEST(ParallelTestSuit, SortednessTest) {
+    std::vector<double> v(200000);
+    std::iota(v.begin(), v.end(), 0.0);
+    ASSERT_TRUE(py_algo::is_sorted(py_algo::execution::par, v.begin(), v.end()));
+    ASSERT_EQ(1, py_algo::sortedness(py_algo::execution::par, v.begin(), v.end()).runs);
+
+    v[123456] = -1;
+    v[54321] = -1;
+    ASSERT_FALSE(py_algo::is_sorted(py_algo::execution::par, v.begin(), v.end()));
+    ASSERT_EQ(v.begin() + 54321, py_algo::is_sorted_until(py_algo::execution::par, v.begin(), v.end()));
+    ASSERT_EQ(v.begin() + 1, py_algo::is_sorted_until(py_algo::execution::par, v.begin(), v.end(), std::greater<>()));
+
+    auto stats = py_algo::sortedness(py_algo::execution::par, v.begin(), v.end());
+    ASSERT_EQ(v.begin() + 54321, stats.first_violation);
+    ASSERT_EQ(2, stats.descents);
+    ASSERT_EQ(3, stats.runs);
+}
+
 TEST(AlgoTestSuit, IsPartitionedTest) {
     std::vector<float> v = {1.2, 2.2, 3.4, 4.5, 5.6, 6.7, 7.8, 8.9};
     ASSERT_TRUE(py_algo::is_partitioned(v.begin(), v.end(), [](float a) { return a <= 4.5f; }));
@@ -68,6 +244,47 @@ TEST(AlgoTestSuit, IsPartitionedTest) {
     ASSERT_FALSE(py_algo::is_partitioned(v2.begin(), v2.end(), [](int a) { return a % 3 == 0; }));
 }
 
+TEST(AlgoTestSuit, IsPartitionedAtTest) {
+    std::vector<int> v = {1, 3, 5, 7, 8, 10, 12, 14};
+    auto is_odd = [](int a) { return a % 2 == 1; };
+    auto check = py_algo::is_partitioned_at(v.begin(), v.end(), is_odd);
+    ASSERT_TRUE(check);
+    ASSERT_EQ(v.begin() + 4, check.partition_point);
+    ASSERT_EQ(v.begin() + 4, py_algo::is_partitioned_at(py_algo::assume_partitioned, v.begin(), v.end(), is_odd).partition_point);
+
+    v[6] = 13;
+    check = py_algo::is_partitioned_at(v.begin(), v.end(), is_odd);
+    ASSERT_FALSE(check.partitioned);
+    ASSERT_EQ(v.begin() + 4, check.partition_point);
+
+    std::forward_list<int> l = {2, 4, 6, 1};
+    auto check2 = py_algo::is_partitioned_at(l.begin(), l.end(), [](int a) { return a % 2 == 0; });
+    ASSERT_TRUE(check2.partitioned);
+    ASSERT_EQ(1, *check2.partition_point);
+
+    std::vector<int> v2 = {};
+    ASSERT_EQ(v2.end(), py_algo::is_partitioned_at(py_algo::assume_partitioned, v2.begin(), v2.end(), is_odd).partition_point);
+}
+
+TEST(ParallelTestSuit, IsPartitionedAtTest) {
+    std::vector<int> v(200000);
+    std::iota(v.begin(), v.end(), 0);
+    for (std::ptrdiff_t point: {0, 1, 16384, 123457, 200000}) {
+        auto below = [point](int a) { return a < point; };
+        auto check = py_algo::is_partitioned_at(py_algo::execution::par, v.begin(), v.end(), below);
+        ASSERT_TRUE(check.partitioned);
+        ASSERT_EQ(v.begin() + point, check.partition_point);
+        ASSERT_EQ(v.begin() + point, py_algo::is_partitioned_at(py_algo::assume_partitioned, v.begin(), v.end(), below).partition_point);
+    }
+
+    auto small = [](int a) { return a < 100000 || a == 150000 || a == 199999; };
+    auto check = py_algo::is_partitioned_at(py_algo::execution::par, v.begin(), v.end(), small);
+    ASSERT_FALSE(check.partitioned);
+    ASSERT_EQ(v.begin() + 100000, check.partition_point);
+    ASSERT_FALSE(py_algo::is_partitioned(py_algo::execution::par, v.begin(), v.end(), small));
+    ASSERT_TRUE(py_algo::is_partitioned(py_algo::execution::seq, v.begin(), v.end(), [](int a) { return a < 7; }));
+}
+
 
 TEST(AlgoTestSuit, FindNotTest) {
     std::vector<float> v = {1.2, 1.2, 1.2, 1.3, 1.2, 1.4, 1.7, 1.2};
@@ -85,6 +302,85 @@ TEST(AlgoTestSuit, FindBackwardTest) {
     ASSERT_EQ(v2.end(), py_algo::find_backward(v2.begin(), v2.end(), 2));
 }
 
+TEST(AlgoTestSuit, FindAnyOfTest) {
+    std::vector<int> v = {1, 2, 1, 3, 4, 2, 5};
+    ASSERT_EQ(v.begin() + 3, py_algo::find_not_any_of(v.begin(), v.end(), {1, 2}));
+    ASSERT_EQ(v.begin() + 5, py_algo::find_backward_any_of(v.begin(), v.end(), {2, 3}));
+    ASSERT_EQ(v.end(), py_algo::find_backward_any_of(v.begin(), v.end(), {7, 8}));
+    ASSERT_EQ(v.end(), py_algo::find_not_any_of(v.begin(), v.end(), {5, 4, 3, 2, 1}));
+
+    std::vector<int> needles = {};
+    ASSERT_EQ(v.begin(), py_algo::find_not_any_of(v.begin(), v.end(), needles.begin(), needles.end()));
+    ASSERT_EQ(v.end(), py_algo::find_backward_any_of(v.begin(), v.end(), needles.begin(), needles.end()));
+
+    std::list<std::string> l = {"#", "#", "log", "#"};
+    std::forward_list<std::string> sentinels = {"#", "//"};
+    ASSERT_EQ("log", *py_algo::find_not_any_of(l.begin(), l.end(), sentinels.begin(), sentinels.end()));
+    ASSERT_EQ(std::prev(l.end()), py_algo::find_backward_any_of(l.begin(), l.end(), sentinels.begin(), sentinels.end()));
+}
+
+template<typename T>
+void check_needle_kernels() {
+    std::uint32_t seed = 12345;
+    auto next = [&seed] {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    for (std::size_t needle_count: {1, 2, 3, 4, 5, 8, 9, 20, 100}) {
+        std::vector<T> needles;
+        for (std::size_t i = 0; i < needle_count; ++i)
+            needles.push_back(static_cast<T>(next() % 200));
+        for (std::size_t size: {0, 1, 15, 16, 33, 64, 100, 1000}) {
+            std::vector<T> v(size);
+            for (std::size_t trial = 0; trial < 20; ++trial) {
+                for (auto& x: v)
+                    x = next() % 4 != 0 ? needles[next() % needle_count] : static_cast<T>(next() % 256);
+                auto is_needle = [&needles](T x) { return std::find(needles.begin(), needles.end(), x) != needles.end(); };
+                auto expected_not = std::find_if_not(v.begin(), v.end(), is_needle);
+                auto expected_backward = std::find_if(v.rbegin(), v.rend(), is_needle);
+                ASSERT_EQ(expected_not, py_algo::find_not_any_of(v.begin(), v.end(), needles.begin(), needles.end()));
+                ASSERT_EQ(expected_backward == v.rend() ? v.end() : std::prev(expected_backward.base()),
+                          py_algo::find_backward_any_of(v.begin(), v.end(), needles.begin(), needles.end()));
+            }
+        }
+    }
+}
+
+TEST(SimdTestSuit, NeedleKernelsTest) {
+    check_needle_kernels<std::uint8_t>();
+    check_needle_kernels<char>();
+    check_needle_kernels<std::int16_t>();
+    check_needle_kernels<std::uint32_t>();
+    check_needle_kernels<std::int64_t>();
+    check_needle_kernels<float>();
+    check_needle_kernels<double>();
+
+    std::vector<double> v = {std::nan(""), 0.0, 1.0};
+    std::vector<double> needles = {-0.0, std::nan(""), 2, 3, 4, 5, 6, 7, 8, 9};
+    ASSERT_EQ(v.begin(), py_algo::find_not_any_of(v.begin(), v.end(), needles.begin(), needles.end()));
+    ASSERT_EQ(v.begin() + 1, py_algo::find_backward_any_of(v.begin(), v.end(), needles.begin(), needles.end()));
+    ASSERT_EQ(v.begin() + 1, py_algo::find_backward_any_of(v.begin(), v.end(), needles.begin(), needles.begin() + 2));
+
+    // Int literals on a byte buffer are narrowed, and those no byte equals are left out
+    std::vector<std::uint8_t> bytes(100, ' ');
+    bytes[30] = '\t';
+    bytes[60] = 200;
+    ASSERT_EQ(bytes.begin() + 60, py_algo::find_not_any_of(bytes.begin(), bytes.end(), {' ', '\t', '\n', '\r'}));
+    ASSERT_EQ(bytes.begin() + 60, py_algo::find_not_any_of(bytes.begin(), bytes.end(), {32, 9, -56, 456}));
+    ASSERT_EQ(bytes.begin() + 30, py_algo::find_backward_any_of(bytes.begin(), bytes.end(), {9, -56, 456}));
+    ASSERT_EQ(bytes.end(), py_algo::find_backward_any_of(bytes.begin(), bytes.end(), {-1, 256, 1000}));
+    ASSERT_EQ(bytes.begin(), py_algo::find_not_any_of(bytes.begin(), bytes.end(), {-224, 288}));
+
+    // Large sets on the scalar path are looked up
+    std::list<std::uint8_t> listed(bytes.begin(), bytes.end());
+    std::vector<long> many = {0, 1, 2, 3, 4, 5, 6, 7, 9, 32, 288};
+    ASSERT_EQ(60, std::distance(listed.begin(), py_algo::find_not_any_of(listed.begin(), listed.end(), many.begin(), many.end())));
+    ASSERT_EQ(99, std::distance(listed.begin(), py_algo::find_backward_any_of(listed.begin(), listed.end(), many.begin(), many.end())));
+    std::list<double> values = {0.5, 2.0, 2.5, 9.0};
+    ASSERT_EQ(std::next(values.begin(), 3), py_algo::find_backward_any_of(values.begin(), values.end(), needles.begin(), needles.end()));
+    ASSERT_EQ(values.begin(), py_algo::find_not_any_of(values.begin(), values.end(), needles.begin(), needles.end()));
+}
+
 TEST(AlgoTestSuit, IsPalindromeTest) {
     std::vector<int> v = {1, 2, 2, 2, 3, 2, 2, 2, 1};
     ASSERT_TRUE(py_algo::is_palindrome(v.begin(), v.end()));
@@ -94,6 +390,261 @@ TEST(AlgoTestSuit, IsPalindromeTest) {
 
     std::vector<int> v3 = {1, 2, 3, 2, 2, 4, 2, 1};
     ASSERT_FALSE(py_algo::is_palindrome(v3.begin(), v3.end()));
+
+    std::list<int> l = {1, 2, 3, 2, 1};
+    ASSERT_TRUE(py_algo::is_palindrome(l.begin(), l.end()));
+    l.push_back(1);
+    ASSERT_FALSE(py_algo::is_palindrome(l.begin(), l.end()));
+
+    ASSERT_TRUE(py_algo::is_palindrome("racecar"));
+    ASSERT_FALSE(py_algo::is_palindrome(std::string("palindrome")));
+    static_assert(py_algo::is_palindrome(std::string_view("abba")));
+
+    std::span<const int> s(v);
+    ASSERT_TRUE(py_algo::is_palindrome(s));
+    ASSERT_FALSE(py_algo::is_palindrome(s.first(4)));
+}
+
+template<typename T>
+void check_palindrome_kernels() {
+    for (std::size_t size: {0, 1, 2, 15, 16, 17, 31, 32, 33, 64, 65, 127, 128, 129, 1000, 1001}) {
+        std::vector<T> v(size);
+        for (std::size_t i = 0; i < size; ++i)
+            v[i] = static_cast<T>(std::min(i, size - 1 - i) % 100);
+        ASSERT_TRUE(py_algo::is_palindrome(v.begin(), v.end()));
+        for (std::size_t i = 0; i < size; i += 1 + size / 13) {
+            auto saved = v[i];
+            v[i] = T(101);
+            ASSERT_EQ(size % 2 == 1 && i == size / 2, py_algo::is_palindrome(v.begin(), v.end()));
+            v[i] = saved;
+        }
+    }
+}
+
+TEST(SimdTestSuit, PalindromeKernelsTest) {
+    check_palindrome_kernels<std::int8_t>();
+    check_palindrome_kernels<std::uint16_t>();
+    check_palindrome_kernels<std::int32_t>();
+    check_palindrome_kernels<std::uint64_t>();
+    check_palindrome_kernels<float>();
+    check_palindrome_kernels<double>();
+
+    std::vector<double> v(40, 1.0);
+    v[3] = std::nan("");
+    v[36] = std::nan("");
+    ASSERT_FALSE(py_algo::is_palindrome(v.begin(), v.end()));
+}
+
+TEST(ParallelTestSuit, IsPalindromeTest) {
+    std::vector<int> v(300001);
+    for (std::size_t i = 0; i < v.size(); ++i)
+        v[i] = static_cast<int>(std::min(i, v.size() - 1 - i));
+    ASSERT_TRUE(py_algo::is_palindrome(py_algo::execution::par, v.begin(), v.end()));
+    ASSERT_TRUE(py_algo::is_palindrome(py_algo::execution::par, v.begin(), v.begin() + 1));
+
+    v[250000] = -1;
+    ASSERT_FALSE(py_algo::is_palindrome(py_algo::execution::par, v.begin(), v.end()));
+    ASSERT_FALSE(py_algo::is_palindrome(py_algo::execution::seq, v.begin(), v.end()));
+
+    std::list<int> l(v.begin(), v.end());
+    ASSERT_FALSE(py_algo::is_palindrome(py_algo::execution::par, l.begin(), l.end()));
+}
+
+TEST(ParallelTestSuit, QuantifiersTest) {
+    std::vector<int> v(100000, 1);
+    auto is_one = [](int a) { return a == 1; };
+    auto is_two = [](int a) { return a == 2; };
+
+    ASSERT_TRUE(py_algo::all_of(py_algo::execution::par, v.begin(), v.end(), is_one));
+    ASSERT_FALSE(py_algo::any_of(py_algo::execution::par, v.begin(), v.end(), is_two));
+    ASSERT_TRUE(py_algo::none_of(py_algo::execution::par_unseq, v.begin(), v.end(), is_two));
+    ASSERT_FALSE(py_algo::one_of(py_algo::execution::par, v.begin(), v.end(), is_two));
+
+    v[77777] = 2;
+    ASSERT_FALSE(py_algo::all_of(py_algo::execution::par, v.begin(), v.end(), is_one));
+    ASSERT_TRUE(py_algo::any_of(py_algo::execution::par, v.begin(), v.end(), is_two));
+    ASSERT_FALSE(py_algo::none_of(py_algo::execution::seq, v.begin(), v.end(), is_two));
+    ASSERT_TRUE(py_algo::one_of(py_algo::execution::par, v.begin(), v.end(), is_two));
+
+    v[3] = 2;
+    ASSERT_FALSE(py_algo::one_of(py_algo::execution::par, v.begin(), v.end(), is_two));
+
+    std::vector<int> v2 = {};
+    ASSERT_TRUE(py_algo::all_of(py_algo::execution::par, v2.begin(), v2.end(), is_one));
+    ASSERT_FALSE(py_algo::one_of(py_algo::execution::par, v2.begin(), v2.end(), is_one));
+}
+
+TEST(ParallelTestSuit, QuantifyTest) {
+    std::vector<int> v(300000, 0);
+    v[1234] = 1;
+    v[250000] = 1;
+    auto is_one = [](int a) { return a == 1; };
+    auto stats = py_algo::quantify(py_algo::execution::par, v.begin(), v.end(), is_one);
+    ASSERT_EQ(2, stats.count);
+    ASSERT_EQ(v.begin() + 1234, stats.first_match);
+    ASSERT_EQ(v.begin() + 250000, stats.last_match);
+    ASSERT_FALSE(stats.one_of());
+
+    auto first = py_algo::quantify(py_algo::execution::par, v.begin(), v.end(), is_one, py_algo::quantifier::first_match);
+    ASSERT_EQ(v.begin() + 1234, first.first_match);
+
+    std::atomic<std::size_t> calls{0};
+    auto stats2 = py_algo::quantify(py_algo::execution::par, v.begin(), v.end(), [&calls](int a) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        return a == 0;
+    }, py_algo::quantifier::all_of);
+    ASSERT_FALSE(stats2.all_of());
+    ASSERT_LT(calls.load(), v.size());
+
+    auto none = py_algo::quantify(py_algo::execution::par, v.begin(), v.end(), [](int a) { return a > 1; });
+    ASSERT_TRUE(none.none_of());
+    ASSERT_EQ(v.end(), none.last_match);
+}
+
+TEST(ParallelTestSuit, EarlyExitTest) {
+    std::vector<int> v(1000000, 0);
+    v[0] = 1;
+    std::atomic<std::size_t> calls{0};
+    ASSERT_TRUE(py_algo::any_of(py_algo::execution::par, v.begin(), v.end(), [&calls](int a) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        return a == 1;
+    }));
+    ASSERT_LT(calls.load(), v.size());
+
+    ASSERT_THROW(py_algo::all_of(py_algo::execution::par, v.begin(), v.end(), [](int) -> bool {
+        throw std::runtime_error("predicate failed");
+    }), std::runtime_error);
+}
+
+TEST(ParallelTestSuit, ThreadPoolTest) {
+    py_algo::thread_pool pool(3);
+    ASSERT_EQ(4, pool.concurrency());
+
+    std::vector<std::atomic<int>> hits(1000);
+    pool.run(hits.size(), [&](std::size_t i) {
+        // Nested runs are split on the same pool while the outer one is in flight
+        pool.run(3, [&](std::size_t) { hits[i].fetch_add(1, std::memory_order_relaxed); });
+    });
+    ASSERT_TRUE(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& h) { return h.load() == 3; }));
+
+    ASSERT_THROW(pool.run(100, [](std::size_t i) {
+        if (i == 57)
+            throw std::runtime_error("task failed");
+    }), std::runtime_error);
+
+    py_algo::cancellation_token token;
+    std::atomic<std::size_t> started{0};
+    pool.run(1000, [&](std::size_t) {
+        started.fetch_add(1, std::memory_order_relaxed);
+        token.cancel();
+    }, token);
+    ASSERT_LT(started.load(), 1000);
+    pool.run(10, [](std::size_t) { FAIL(); }, token);
+
+    // The caller runs out of work long before the slow tasks end and sleeps until the last one
+    std::atomic<int> finished{0};
+    for (int repeat = 0; repeat < 20; ++repeat) {
+        pool.run(4, [&](std::size_t i) {
+            if (i % 2 == 1)
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            finished.fetch_add(1, std::memory_order_relaxed);
+        });
+        ASSERT_EQ(4 * (repeat + 1), finished.load());
+    }
+}
+
+// Executor without cancellation support that runs every task on the calling thread
+struct inline_executor {
+    std::size_t runs = 0;
+
+    std::size_t concurrency() const noexcept {
+        return 4;
+    }
+
+    template<typename Function>
+    void run(std::size_t _tasks, Function&& _fn) {
+        ++runs;
+        for (std::size_t i = 0; i < _tasks; ++i)
+            _fn(i);
+    }
+};
+
+TEST(ParallelTestSuit, ExecutorPolicyTest) {
+    py_algo::thread_pool pool(3);
+    auto on_pool = py_algo::execution::par.on(pool);
+    std::vector<int> v(1000000, 0);
+    ASSERT_TRUE(py_algo::none_of(on_pool, v.begin(), v.end(), [](int a) { return a != 0; }));
+    ASSERT_EQ(v.end(), py_algo::find_not(on_pool, v.begin(), v.end(), 0));
+    ASSERT_TRUE(py_algo::is_palindrome(on_pool, v.begin(), v.end()));
+
+    v[654321] = 2;
+    v[876543] = 1;
+    ASSERT_EQ(v.begin() + 654321, py_algo::find_not(on_pool, v.begin(), v.end(), 0));
+    ASSERT_EQ(v.begin() + 654321, py_algo::find_not(py_algo::execution::par, v.begin(), v.end(), 0));
+    ASSERT_TRUE(py_algo::one_of(on_pool, v.begin(), v.end(), [](int a) { return a == 1; }));
+    ASSERT_FALSE(py_algo::is_palindrome(on_pool, v.begin(), v.end()));
+    ASSERT_FALSE(py_algo::is_partitioned(on_pool, v.begin(), v.end(), [](int a) { return a == 0; }));
+
+    std::atomic<std::int64_t> total{0};
+    py_algo::parallel_for(on_pool, py_algo::xrange<std::int64_t>(100000), [&](std::int64_t x) {
+        total.fetch_add(x, std::memory_order_relaxed);
+    }, py_algo::schedule::dynamic);
+    ASSERT_EQ(py_algo::xrange<std::int64_t>(100000).sum(), total.load());
+
+    inline_executor custom;
+    std::atomic<std::size_t> calls{0};
+    ASSERT_TRUE(py_algo::any_of(py_algo::execution::par.on(custom), v.begin(), v.end(), [&calls](int a) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        return a == 2;
+    }));
+    ASSERT_EQ(1, custom.runs);
+    ASSERT_LT(calls.load(), v.size());
+    ASSERT_EQ(v.begin() + 654321, py_algo::find_not(py_algo::execution::par_unseq.on(custom), v.begin(), v.end(), 0));
+}
+
+template<typename T>
+void check_find_kernels() {
+    for (std::size_t size: {0, 1, 7, 16, 31, 32, 33, 64, 127, 128, 129, 1000}) {
+        std::vector<T> v(size, T(3));
+        ASSERT_EQ(v.end(), py_algo::find_not(v.begin(), v.end(), T(3)));
+        ASSERT_EQ(v.end(), py_algo::find_backward(v.begin(), v.end(), T(5)));
+        for (std::size_t i = 0; i < size; i += 1 + size / 17) {
+            v[i] = T(5);
+            ASSERT_EQ(v.begin() + i, py_algo::find_not(v.begin(), v.end(), T(3)));
+            ASSERT_EQ(v.begin() + i, py_algo::find_backward(v.begin(), v.end(), T(5)));
+            ASSERT_EQ(v.begin() + i, py_algo::find_not(v.begin() + i, v.end(), T(3)));
+            // Needles of other types are narrowed to T when it holds them
+            ASSERT_EQ(v.begin() + i, py_algo::find_not(v.begin(), v.end(), 3));
+            ASSERT_EQ(v.begin() + i, py_algo::find_backward(v.begin(), v.end(), 5LL));
+            if constexpr (std::is_floating_point_v<T>) {
+                ASSERT_EQ(v.begin() + i, py_algo::find_backward(v.begin(), v.end(), 5.0));
+            }
+            v[i] = T(3);
+        }
+        // and nothing equals a needle it cannot hold
+        auto foreign = std::is_floating_point_v<T> ? 0.1L : 1e30L;
+        ASSERT_EQ(v.begin(), py_algo::find_not(v.begin(), v.end(), foreign));
+        ASSERT_EQ(v.end(), py_algo::find_backward(v.begin(), v.end(), foreign));
+        ASSERT_EQ(v.begin(), py_algo::find_not(v.begin(), v.end(), std::numeric_limits<double>::quiet_NaN()));
+        if constexpr (std::is_integral_v<T> && sizeof(T) < sizeof(long long)) {
+            ASSERT_EQ(v.begin(), py_algo::find_not(v.begin(), v.end(), 3 + (1LL << 8 * sizeof(T))));
+            ASSERT_EQ(v.end(), py_algo::find_backward(v.begin(), v.end(), 3 + (1LL << 8 * sizeof(T))));
+        }
+    }
+}
+
+TEST(SimdTestSuit, FindKernelsTest) {
+    check_find_kernels<std::uint8_t>();
+    check_find_kernels<std::int16_t>();
+    check_find_kernels<std::int32_t>();
+    check_find_kernels<std::int64_t>();
+    check_find_kernels<float>();
+    check_find_kernels<double>();
+
+    std::vector<float> v(100, 0.f);
+    v[40] = -0.f;
+    ASSERT_EQ(v.end(), py_algo::find_not(v.begin(), v.end(), 0.f));
+    ASSERT_EQ(v.begin() + 99, py_algo::find_backward(v.begin(), v.end(), -0.f));
 }
 
 TEST(XrangeTestSuit, ConstructorsTest) {
@@ -125,6 +676,292 @@ TEST(XrangeTestSuit, ConstructorsTest) {
     ASSERT_EQ(p3, result3.end());
 }
 
+TEST(XrangeTestSuit, FloatCountTest) {
+    // 0.3 / 0.1 rounds above 3, but the element at index 3 is the excluded end itself
+    ASSERT_EQ(3, py_algo::xrange<double>(0, 0.1 * 3, 0.1).size());
+    ASSERT_EQ(7, py_algo::xrange<double>(0, 0.7, 0.1).size());
+    ASSERT_EQ(0, py_algo::xrange<double>(1, 0, 0.5).size());
+    ASSERT_EQ(1, py_algo::xrange<double>(0, 1e-320, 1).size());
+    ASSERT_THROW(py_algo::xrange<double>(0, INFINITY, 1), std::length_error);
+
+    for (double start: {-3.7, 0.0, 0.1, 1e6}) {
+        for (double step: {0.1, 0.07, 1e-3, -0.3, -1.1}) {
+            for (int n: {1, 10, 1000}) {
+                double end = start + n * step;
+                auto range = py_algo::xrange<double>(start, end, step);
+                ASSERT_GT(range.size(), 0);
+                auto last = range[range.size() - 1];
+                ASSERT_TRUE(step > 0 ? last < end : last > end);
+                ASSERT_FALSE(step > 0 ? *range.end() < end : *range.end() > end);
+            }
+        }
+    }
+
+    auto range = py_algo::xrange<float>(0.f, 1e6f, 0.1f);
+    ASSERT_LT(range[range.size() - 1], 1e6f);
+    ASSERT_GE(*range.end(), 1e6f);
+}
+
+template<typename T>
+void check_fill(py_algo::xrange<T> _range) {
+    std::vector<T> expected(_range.begin(), _range.end());
+    ASSERT_EQ(expected, _range.to_vector());
+
+    std::vector<T> filled(_range.size() + 1, T(-1));
+    ASSERT_EQ(filled.begin() + _range.size(), _range.fill(filled.begin()));
+    ASSERT_EQ(T(-1), filled.back());
+    filled.pop_back();
+    ASSERT_EQ(expected, filled);
+}
+
+TEST(XrangeTestSuit, FillTest) {
+    for (std::size_t n: {0, 1, 3, 4, 7, 8, 9, 31, 1000}) {
+        check_fill(py_algo::xrange<double>(0.1, 0.1 + n * 0.07, 0.07));
+        check_fill(py_algo::xrange<float>(-2.5f, -2.5f + n * 0.3f, 0.3f));
+        check_fill(py_algo::xrange<int>(5, 5 + 3 * static_cast<int>(n), 3));
+    }
+    for (const auto& part: py_algo::xrange<double>(-1, 1, 0.001).split(7))
+        check_fill(part);
+    for (const auto& part: py_algo::xrange<float>(0, 1e4f, 0.37f).chunks(333))
+        check_fill(part);
+
+    std::list<long> l;
+    py_algo::xrange<long>(10, 0, -4).fill(std::back_inserter(l));
+    ASSERT_EQ((std::list<long>{10, 6, 2}), l);
+}
+
+TEST(XrangeTestSuit, RandomAccessTest) {
+    auto range1 = py_algo::xrange<int>(1, 8, 2);
+    ASSERT_EQ(4, range1.size());
+    ASSERT_EQ(4, std::distance(range1.begin(), range1.end()));
+    ASSERT_EQ(5, range1[2]);
+    ASSERT_EQ(7, *(range1.begin() + 3));
+    ASSERT_EQ(7, *(range1.end() - 1));
+    ASSERT_EQ(3, range1.begin()[1]);
+
+    auto range2 = py_algo::xrange<int>(10, 0, -3);
+    std::vector<int> result2 = {10, 7, 4, 1};
+    ASSERT_EQ(result2, std::vector<int>(range2.begin(), range2.end()));
+
+    ASSERT_TRUE(py_algo::xrange<int>(5, 5).empty());
+    ASSERT_TRUE(py_algo::xrange<unsigned>(7, 3).empty());
+    ASSERT_EQ(3, py_algo::xrange(0.5, 3.1).size());
+    ASSERT_THROW(py_algo::xrange<int>(0, 10, 0), std::invalid_argument);
+
+    auto range3 = py_algo::xrange<long long>(1000000);
+    auto shard = range3.begin() + static_cast<std::ptrdiff_t>(range3.size() / 4);
+    ASSERT_EQ(250000, *shard);
+    ASSERT_EQ(750000, range3.end() - shard);
+
+    // Elements at the far end of the widest ranges are computed without overflow
+    auto range4 = py_algo::xrange<std::int64_t>(INT64_MIN, INT64_MAX, 3);
+    ASSERT_EQ(6148914691236517205u, range4.size());
+    ASSERT_EQ(INT64_MAX - 3, range4[range4.size() - 1]);
+    ASSERT_EQ(INT64_MAX - 3, *(range4.end() - 1));
+    ASSERT_EQ(INT64_MIN + 3, range4.begin()[1]);
+    ASSERT_EQ(range4.size() - 1, range4.index_of(INT64_MAX - 3));
+    auto range5 = py_algo::xrange<std::int64_t>(INT64_MAX, INT64_MIN, -7);
+    ASSERT_EQ(INT64_MAX - 7 * static_cast<std::int64_t>(range5.size() - 1), range5[range5.size() - 1]);
+
+    // and counts past PTRDIFF_MAX are rejected
+    ASSERT_THROW(py_algo::xrange<std::uint64_t>(0, (std::uint64_t(1) << 63) + 10), std::length_error);
+    ASSERT_THROW(py_algo::xrange<std::uint64_t>(~std::uint64_t(0)), std::length_error);
+    ASSERT_EQ(PTRDIFF_MAX, py_algo::xrange<std::uint64_t>(0, std::uint64_t(1) << 63).end() - py_algo::xrange<std::uint64_t>(0, std::uint64_t(1) << 63).begin());
+}
+
+TEST(XrangeTestSuit, AnalyticQueriesTest) {
+    auto range1 = py_algo::xrange<int>(3, 40, 4);
+    std::vector<int> values1(range1.begin(), range1.end());
+    for (int x = -5; x < 50; ++x) {
+        bool present = std::find(values1.begin(), values1.end(), x) != values1.end();
+        ASSERT_EQ(present, range1.contains(x));
+        if (present)
+            ASSERT_EQ(x, range1[range1.index_of(x)]);
+        else
+            ASSERT_EQ(range1.size(), range1.index_of(x));
+    }
+    ASSERT_EQ(std::accumulate(values1.begin(), values1.end(), 0), range1.sum());
+    ASSERT_EQ(39, range1.nth(9));
+    ASSERT_THROW(range1.nth(10), std::out_of_range);
+
+    auto range2 = py_algo::xrange<int>(20, -20, -3);
+    ASSERT_TRUE(range2.contains(-16));
+    ASSERT_FALSE(range2.contains(-18));
+    ASSERT_TRUE(range2.contains(-19));
+    ASSERT_EQ(7, range2.sum());
+
+    // Sums are exact whenever they fit the element type, whatever the partial products
+    static_assert(py_algo::xrange<int>(-50000, 50000).sum() == -50000);
+    ASSERT_EQ(-50000, py_algo::xrange<int>(-50000, 50000).sum());
+    ASSERT_EQ(std::numeric_limits<int>::min() + 1,
+              py_algo::xrange<int>(std::numeric_limits<int>::min() + 1, std::numeric_limits<int>::max()).sum());
+    ASSERT_EQ(-127, py_algo::xrange<std::int8_t>(-127, 127).sum());
+    ASSERT_EQ(-(std::int64_t(1) << 61), py_algo::xrange<std::int64_t>(-(std::int64_t(1) << 61), std::int64_t(1) << 61).sum());
+    // and wrap modulo 2^n when they do not
+    ASSERT_EQ(1, py_algo::xrange<int>(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()).sum());
+    ASSERT_EQ(32769, py_algo::xrange<std::uint16_t>(0, 65535).sum());
+
+    auto range3 = py_algo::xrange(0.5, 10.0, 0.5);
+    ASSERT_TRUE(range3.contains(4.5));
+    ASSERT_FALSE(range3.contains(4.75));
+    ASSERT_DOUBLE_EQ(95.0, range3.sum());
+
+    auto common = py_algo::xrange<int>(0, 100, 6).intersect(py_algo::xrange<int>(4, 90, 8));
+    std::vector<int> result = {12, 36, 60, 84};
+    ASSERT_EQ(result, std::vector<int>(common.begin(), common.end()));
+    auto common2 = py_algo::xrange<int>(50, 0, -5).intersect(py_algo::xrange<int>(1, 60, 3));
+    std::vector<int> result2 = {40, 25, 10};
+    ASSERT_EQ(result2, std::vector<int>(common2.begin(), common2.end()));
+    ASSERT_TRUE(py_algo::xrange<int>(0, 100, 2).intersect(py_algo::xrange<int>(1, 100, 2)).empty());
+
+    // Bounds and steps at the limits of the element type
+    auto check_intersect = [](auto _a, auto _b) {
+        std::vector<typename decltype(_a)::value_type> expected;
+        std::copy_if(_a.begin(), _a.end(), std::back_inserter(expected), [&_b](auto x) { return _b.contains(x); });
+        auto common = _a.intersect(_b);
+        return expected == std::vector<typename decltype(_a)::value_type>(common.begin(), common.end());
+    };
+    typedef unsigned long long ull;
+    constexpr ull high_bit = ull(1) << 63;
+    ASSERT_TRUE(check_intersect(py_algo::xrange<ull>(high_bit + 5, high_bit + 1000, 6), py_algo::xrange<ull>(high_bit, high_bit + 900, 4)));
+    ASSERT_TRUE(check_intersect(py_algo::xrange<ull>(high_bit - 50, high_bit + 50, 3), py_algo::xrange<ull>(7, high_bit + 40, 5)));
+    ASSERT_TRUE(check_intersect(py_algo::xrange<std::int64_t>(INT64_MAX - 20, INT64_MAX, 3), py_algo::xrange<std::int64_t>(INT64_MAX - 30, INT64_MAX, 2)));
+    ASSERT_TRUE(check_intersect(py_algo::xrange<std::int64_t>(INT64_MIN + 20, INT64_MIN, -3), py_algo::xrange<std::int64_t>(INT64_MIN, INT64_MIN + 30, 2)));
+    ASSERT_TRUE(check_intersect(py_algo::xrange<std::uint32_t>(0, 4000000000u, 3999999999u), py_algo::xrange<std::uint32_t>(0, 4000000000u, 3999999998u)));
+    auto huge = py_algo::xrange<ull>(0, ~ull(0), ull(1) << 62).intersect(py_algo::xrange<ull>(0, ~ull(0), ull(3) << 61));
+    ASSERT_EQ((std::vector<ull>{0, ull(3) << 62}), std::vector<ull>(huge.begin(), huge.end()));
+    // An lcm beyond value_type leaves room for one common element at most, here 0 and 67
+    ASSERT_EQ((std::vector<std::int8_t>{0}), py_algo::xrange<std::int8_t>(0, 100, 11).intersect(py_algo::xrange<std::int8_t>(0, 100, 13)).to_vector());
+    ASSERT_EQ((std::vector<std::int8_t>{67}), py_algo::xrange<std::int8_t>(1, 100, 11).intersect(py_algo::xrange<std::int8_t>(2, 100, 13)).to_vector());
+    ASSERT_TRUE(check_intersect(py_algo::xrange<std::int8_t>(120, -128, -11), py_algo::xrange<std::int8_t>(-120, 127, 13)));
+    // or two in the full span of a signed type, which no step of it can yield
+    ASSERT_THROW(py_algo::xrange<std::int8_t>(-128, 127, 11).intersect(py_algo::xrange<std::int8_t>(-128, 127, 13)), std::out_of_range);
+
+    ASSERT_EQ(range1.begin() + 5, py_algo::find_backward(range1.begin(), range1.end(), 23));
+    ASSERT_EQ(range1.end(), py_algo::find_backward(range1.begin(), range1.end(), 24));
+    ASSERT_EQ(range1.begin() + 2, py_algo::find_backward(range1.begin() + 2, range1.end(), 11));
+    ASSERT_EQ(range1.begin() + 4, py_algo::find_backward(range1.begin(), range1.begin() + 4, 19));
+
+    // A step below the ulp repeats values: 1e16 is yielded at indices 0 to 2, 1e16 + 2 at 3 to 6
+    auto flat = py_algo::xrange<double>(1e16, 1e16 + 8, 0.5);
+    ASSERT_EQ(1e16, flat[2]);
+    ASSERT_NE(1e16, flat[3]);
+    ASSERT_EQ(flat.begin() + 2, py_algo::find_backward(flat.begin(), flat.end(), 1e16));
+    ASSERT_EQ(flat.begin() + 1, py_algo::find_backward(flat.begin(), flat.begin() + 2, 1e16));
+    ASSERT_EQ(flat.begin() + 6, py_algo::find_backward(flat.begin(), flat.end(), flat[3]));
+    ASSERT_EQ(flat.begin() + 4, py_algo::find_backward(flat.begin(), flat.begin() + 5, flat[3]));
+    ASSERT_EQ(flat.begin() + 3, py_algo::find_backward(flat.begin() + 3, flat.begin() + 4, flat[3]));
+    ASSERT_EQ(flat.end(), py_algo::find_backward(flat.begin() + 3, flat.end(), 1e16));
+    ASSERT_EQ(0, flat.index_of(1e16));
+    ASSERT_EQ(3, flat.index_of(flat[3]));
+    ASSERT_TRUE(flat.slice(1, 4).contains(1e16));
+    ASSERT_EQ(0, flat.slice(1, 4).index_of(1e16));
+    ASSERT_EQ(2, flat.slice(1, 4).index_of(flat[3]));
+    ASSERT_EQ(0, flat.slice(5, 7).index_of(flat[3]));
+    ASSERT_FALSE(flat.slice(3, 7).contains(1e16));
+    for (std::size_t first = 0; first < flat.size(); ++first) {
+        for (std::size_t last = first; last <= flat.size(); ++last) {
+            auto part = flat.slice(first, last);
+            for (double x: {1e16, flat[3], flat[8], 1e16 + 1}) {
+                auto expected = std::find(part.begin(), part.end(), x);
+                ASSERT_EQ(static_cast<std::size_t>(expected - part.begin()), part.index_of(x));
+                auto backward = std::find(std::make_reverse_iterator(part.end()), std::make_reverse_iterator(part.begin()), x);
+                ASSERT_EQ(backward.base() == part.begin() ? part.end() : std::prev(backward.base()),
+                          py_algo::find_backward(part.begin(), part.end(), x));
+            }
+        }
+    }
+    // Long runs are bisected rather than walked
+    auto tiny = py_algo::xrange<double>(1.0, 1.0 + 1e-6, 1e-20);
+    ASSERT_EQ(tiny.begin() + 11102, py_algo::find_backward(tiny.begin(), tiny.begin() + 100000, 1.0));
+    ASSERT_TRUE(py_algo::is_sorted(range1.begin(), range1.end()));
+    ASSERT_FALSE(py_algo::is_sorted(range2.begin(), range2.end()));
+    ASSERT_FALSE(py_algo::is_palindrome(range2.begin(), range2.end()));
+}
+
+TEST(XrangeTestSuit, SplitTest) {
+    auto range = py_algo::xrange<int>(3, 30, 4);
+    auto chunks = range.chunks(3);
+    ASSERT_EQ(3u, chunks.size());
+    ASSERT_EQ((std::vector<int>{3, 7, 11}), std::vector<int>(chunks[0].begin(), chunks[0].end()));
+    ASSERT_EQ((std::vector<int>{27}), std::vector<int>(chunks[2].begin(), chunks[2].end()));
+    ASSERT_EQ(1u, chunks[1].index_of(19));
+    ASSERT_TRUE(chunks[1].contains(15));
+    ASSERT_FALSE(chunks[1].contains(11));
+    ASSERT_EQ(15 + 19 + 23, chunks[1].sum());
+    ASSERT_EQ(chunks[1].begin() + 2, py_algo::find_backward(chunks[1].begin(), chunks[1].end(), 23));
+
+    auto parts = py_algo::xrange<int>(10, 0, -1).split(4);
+    ASSERT_EQ(4u, parts.size());
+    ASSERT_EQ((std::vector<int>{10, 9, 8}), std::vector<int>(parts[0].begin(), parts[0].end()));
+    ASSERT_EQ((std::vector<int>{2, 1}), std::vector<int>(parts[3].begin(), parts[3].end()));
+    ASSERT_TRUE(py_algo::xrange<int>(2).split(3)[2].empty());
+    ASSERT_EQ(5, py_algo::xrange<int>(0, 20).slice(5, 8).intersect(py_algo::xrange<int>(1, 10, 2)).nth(0));
+
+    auto floats = py_algo::xrange<double>(0.1, 2.3, 0.07);
+    std::vector<double> sequential(floats.begin(), floats.end());
+    std::vector<double> joined;
+    for (const auto& part: floats.split(7))
+        joined.insert(joined.end(), part.begin(), part.end());
+    ASSERT_EQ(sequential, joined);
+
+    ASSERT_THROW(range.chunks(0), std::invalid_argument);
+    ASSERT_THROW(range.split(0), std::invalid_argument);
+    ASSERT_THROW(range.slice(2, 8), std::out_of_range);
+}
+
+TEST(ParallelTestSuit, ParallelForTest) {
+    auto range = py_algo::xrange<std::int64_t>(-5, 100000, 3);
+    for (auto kind: {py_algo::schedule::static_split, py_algo::schedule::guided, py_algo::schedule::dynamic}) {
+        for (std::size_t grain: {0, 1, 1000}) {
+            std::atomic<std::int64_t> total{0};
+            std::atomic<std::size_t> calls{0};
+            py_algo::parallel_for(range, [&](std::int64_t x) {
+                total.fetch_add(x, std::memory_order_relaxed);
+                calls.fetch_add(1, std::memory_order_relaxed);
+            }, kind, grain);
+            ASSERT_EQ(range.sum(), total.load());
+            ASSERT_EQ(range.size(), calls.load());
+        }
+    }
+
+    auto floats = py_algo::xrange<double>(0, 1, 0.001);
+    std::vector<double> seen(floats.size());
+    py_algo::parallel_for(floats, [&](double x) { seen[floats.index_of(x)] = x; }, py_algo::schedule::dynamic, 16);
+    ASSERT_EQ(std::vector<double>(floats.begin(), floats.end()), seen);
+
+    py_algo::parallel_for(py_algo::xrange<int>(0), [](int) { FAIL(); });
+    ASSERT_THROW(py_algo::parallel_for(py_algo::xrange<int>(100), [](int x) {
+        if (x == 42)
+            throw std::runtime_error("element failed");
+    }, py_algo::schedule::guided), std::runtime_error);
+}
+
+TEST(ParallelTestSuit, ForEachIndexedTest) {
+    std::vector<std::int64_t> v(100003, 1);
+    for (auto kind: {py_algo::schedule::static_split, py_algo::schedule::guided, py_algo::schedule::dynamic}) {
+        py_algo::parallel_for_each_indexed(v, [](std::size_t i, std::int64_t& x) {
+            x += static_cast<std::int64_t>(i);
+        }, kind, 1000);
+    }
+    for (std::size_t i = 0; i < v.size(); ++i)
+        ASSERT_EQ(1 + 3 * static_cast<std::int64_t>(i), v[i]);
+
+    py_algo::thread_pool pool(3);
+    std::array<int, 5> a = {};
+    py_algo::parallel_for_each_indexed(py_algo::execution::par.on(pool), a, [](std::size_t i, int& x) {
+        x = static_cast<int>(i * i);
+    });
+    ASSERT_EQ((std::array<int, 5>{0, 1, 4, 9, 16}), a);
+
+    std::atomic<std::size_t> seen{0};
+    py_algo::parallel_for_each_indexed(py_algo::execution::seq, py_algo::xrange<int>(10, 20), [&](std::size_t i, int x) {
+        if (static_cast<std::size_t>(x) == i + 10)
+            seen.fetch_add(1);
+    });
+    ASSERT_EQ(10, seen.load());
+}
+
 TEST(ZipTestSuit, ConstructorTest) {
     std::vector<int> v = {1, 2, 3, 4, 5};
     std::vector<std::string> v2 = {"Hey,", "bro!", "Awesome", "test", ")", "))"};
@@ -135,10 +972,606 @@ TEST(ZipTestSuit, ConstructorTest) {
                                                        {4, "test"},
                                                        {5, ")"}};
     auto p1 = result.begin();
-    for (auto i: zip1) {
-        ASSERT_EQ(p1->first, i.first);
-        ASSERT_EQ(p1->second, i.second);
+    for (auto [number, word]: zip1) {
+        ASSERT_EQ(p1->first, number);
+        ASSERT_EQ(p1->second, word);
         p1++;
     }
     ASSERT_EQ(p1, result.end());
 }
+
+TEST(ZipTestSuit, VariadicReferencesTest) {
+    std::list<int> l = {1, 2, 3, 4, 5};
+    std::vector<char> v = {'a', 'b', 'c', 'd'};
+    const std::vector<std::string> v2 = {"one", "two", "three", "four", "five", "six"};
+
+    std::size_t steps = 0;
+    for (auto [number, letter, word]: py_algo::zip(l, v, v2)) {
+        ASSERT_EQ(&word, &v2[steps]);
+        letter = static_cast<char>(letter - 'a' + 'A');
+        number *= 10;
+        steps++;
+    }
+    ASSERT_EQ(4, steps);
+    ASSERT_EQ((std::vector<char>{'A', 'B', 'C', 'D'}), v);
+    ASSERT_EQ((std::list<int>{10, 20, 30, 40, 5}), l);
+
+    auto zip1 = py_algo::zip(v, v2);
+    static_assert(std::is_base_of_v<std::tuple<char&, const std::string&>, decltype(*zip1.begin())>);
+    ASSERT_EQ("one", std::get<1>(*zip1.begin()));
+}
+
+TEST(ZipTestSuit, SortTest) {
+    std::vector<int> keys = {5, 3, 9, 1, 3, 7};
+    std::vector<std::string> names = {"five", "three", "nine", "one", "three'", "seven"};
+    std::vector<double> weights = {0.5, 0.3, 0.9, 0.1, 0.33, 0.7};
+    auto columns = py_algo::zip(keys, names, weights);
+
+    std::sort(columns.begin(), columns.end());
+    ASSERT_EQ((std::vector<int>{1, 3, 3, 5, 7, 9}), keys);
+    ASSERT_EQ((std::vector<std::string>{"one", "three", "three'", "five", "seven", "nine"}), names);
+    ASSERT_EQ((std::vector<double>{0.1, 0.3, 0.33, 0.5, 0.7, 0.9}), weights);
+
+    std::stable_sort(columns.begin(), columns.end(), [](const auto& _l, const auto& _r) {
+        return std::get<0>(_l) % 3 < std::get<0>(_r) % 3;
+    });
+    ASSERT_EQ((std::vector<int>{3, 3, 9, 1, 7, 5}), keys);
+    ASSERT_EQ((std::vector<std::string>{"three", "three'", "nine", "one", "seven", "five"}), names);
+
+    auto middle = std::partition(columns.begin(), columns.end(), [](const auto& _value) {
+        return std::get<0>(_value) > 4;
+    });
+    ASSERT_EQ(3, middle - columns.begin());
+    for (auto [key, name, weight]: columns)
+        ASSERT_DOUBLE_EQ(key / 10.0, std::floor(weight * 10) / 10.0);
+}
+
+TEST(ZipTestSuit, SortByKeyTest) {
+    std::vector<int> keys = {4, 2, 2, 8, 0, 6, 2};
+    std::vector<std::string> names = {"d", "b1", "b2", "h", "a", "f", "b3"};
+    ASSERT_EQ((std::vector<std::size_t>{4, 1, 2, 6, 0, 5, 3}), py_algo::argsort(keys.begin(), keys.end()));
+
+    py_algo::sort_by_key(py_algo::zip(keys, names));
+    ASSERT_EQ((std::vector<int>{0, 2, 2, 2, 4, 6, 8}), keys);
+    ASSERT_EQ((std::vector<std::string>{"a", "b1", "b2", "b3", "d", "f", "h"}), names);
+
+    py_algo::sort_by_key(py_algo::zip(keys, names), std::greater<>());
+    ASSERT_EQ((std::vector<int>{8, 6, 4, 2, 2, 2, 0}), keys);
+    ASSERT_EQ((std::vector<std::string>{"h", "f", "d", "b1", "b2", "b3", "a"}), names);
+}
+
+TEST(ZipTestSuit, SizeTest) {
+    std::list<int> l = {1, 2, 3, 4, 5};
+    std::vector<char> v = {'a', 'b', 'c', 'd'};
+    std::forward_list<int> fl = {7, 8, 9};
+
+    auto counted = py_algo::zip(l, v);
+    ASSERT_EQ(4, counted.size());
+    ASSERT_EQ(4, std::distance(counted.begin(), counted.end()));
+    ASSERT_EQ(4, std::get<0>(*std::prev(counted.end())));
+    std::vector<int> none;
+    ASSERT_TRUE(py_algo::zip(l, none).empty());
+
+    py_algo::xrange<int> range(10, 20);
+    auto columns = py_algo::zip(v, range);
+    ASSERT_EQ(4, columns.size());
+    ASSERT_EQ('c', std::get<0>(columns[2]));
+    ASSERT_EQ(12, std::get<1>(columns[2]));
+    ASSERT_EQ(3, (columns.end() - 1).index());
+
+    auto walked = py_algo::zip(fl, v);
+    ASSERT_EQ(3, std::distance(walked.begin(), walked.end()));
+
+    ASSERT_EQ(5, py_algo::zip_strict(l, l).size());
+    ASSERT_THROW(py_algo::zip_strict(l, v), std::invalid_argument);
+    ASSERT_THROW(py_algo::zip_strict(v, v, fl), std::invalid_argument);
+}
+
+TEST(ZipTestSuit, LongestTest) {
+    std::list<int> l = {1, 2, 3, 4, 5};
+    std::vector<std::string> v = {"a", "b"};
+    py_algo::xrange<int> range(3);
+
+    auto rows = py_algo::zip_longest(l, v, range);
+    ASSERT_EQ(5, rows.size());
+    std::vector<std::tuple<int, std::string, int>> result(rows.begin(), rows.end());
+    ASSERT_EQ((std::vector<std::tuple<int, std::string, int>>{{1, "a", 0}, {2, "b", 1}, {3, "", 2}, {4, "", 0}, {5, "", 0}}),
+              result);
+
+    auto filled = rows.with_fill(0, "-", -1);
+    auto [number, word, index] = *std::prev(filled.end());
+    ASSERT_EQ(5, number);
+    ASSERT_EQ("-", word);
+    ASSERT_EQ(-1, index);
+    ASSERT_EQ(&l.back(), &number);
+
+    std::vector<int> w = {1, 2, 3, 4, 5, 6};
+    auto columns = py_algo::zip_longest(w, range).with_fill(0, 100);
+    ASSERT_EQ(100, std::get<1>(columns.begin()[4]));
+    auto iter = columns.begin() + 5;
+    iter -= 4;
+    ASSERT_EQ(2, std::get<0>(*iter));
+    ASSERT_EQ(1, std::get<1>(*iter));
+    ASSERT_EQ(6, columns.end() - columns.begin());
+    ASSERT_TRUE(py_algo::zip_longest(v, v).with_fill("", "").size() == 2);
+}
+
+TEST(ZipTestSuit, ReduceTest) {
+    std::vector<int> keys = {1, 2, 3};
+    std::vector<std::string> names = {"a", "bb", "ccc", "dddd"};
+    auto total = py_algo::zip_reduce(py_algo::zip(keys, names), std::size_t(0), [](std::size_t acc, const auto& row) {
+        auto& [key, name] = row;
+        return acc + key * name.size();
+    });
+    ASSERT_EQ(14, total);
+
+    std::vector<double> x(100003), w(100003);
+    std::vector<float> xf(x.size()), wf(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        x[i] = xf[i] = static_cast<float>(i % 17) * 0.25f;
+        w[i] = wf[i] = static_cast<float>(i % 5) - 1.5f;
+    }
+    double expected = 0;
+    for (std::size_t i = 0; i < x.size(); ++i)
+        expected += x[i] * w[i];
+    auto rows = py_algo::zip(x, w);
+    ASSERT_DOUBLE_EQ(expected, py_algo::zip_transform_reduce(rows, 0.0, std::plus<>(), std::multiplies<>()));
+    ASSERT_DOUBLE_EQ(expected + 1, py_algo::zip_transform_reduce(rows, 1.0, std::plus<>(), std::multiplies<>()));
+    ASSERT_FLOAT_EQ(static_cast<float>(expected),
+                    py_algo::zip_transform_reduce(py_algo::zip(xf, wf), 0.0f, std::plus<>(), std::multiplies<float>()));
+    ASSERT_DOUBLE_EQ(expected, py_algo::zip_transform_reduce(py_algo::execution::par, rows, 0.0, std::plus<>(),
+                                                             std::multiplies<>()));
+
+    // Deterministic sums are the same bits on any number of threads
+    auto deterministic = py_algo::zip_transform_reduce(rows, 0.0, std::plus<>(), std::multiplies<>(),
+                                                       py_algo::reduction_order::deterministic);
+    ASSERT_DOUBLE_EQ(expected, deterministic);
+    for (std::size_t workers: {1, 2, 3, 5}) {
+        py_algo::thread_pool pool(workers);
+        ASSERT_EQ(deterministic, py_algo::zip_transform_reduce(py_algo::execution::par.on(pool), rows, 0.0, std::plus<>(),
+                                                               std::multiplies<>(), py_algo::reduction_order::deterministic));
+    }
+
+    // Compare-and-count kernels against a plain loop, with NaNs in the floating point columns
+    w[7] = w[8] = x[8] = std::nan("");
+    std::vector<std::uint16_t> a(1000), b(1000);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        a[i] = static_cast<std::uint16_t>(i * 7919 % 65521);
+        b[i] = static_cast<std::uint16_t>(i * 104729 % 65519);
+    }
+    auto expect_counts = [](auto& _a, auto& _b) {
+        auto columns = py_algo::zip(_a, _b);
+        auto count = [&](auto compare) {
+            long expected_count = 0;
+            for (std::size_t i = 0; i < _a.size(); ++i)
+                expected_count += compare(_a[i], _b[i]);
+            ASSERT_EQ(expected_count + 2, py_algo::zip_transform_reduce(columns, 2L, std::plus<>(), compare));
+            ASSERT_EQ(expected_count, py_algo::zip_transform_reduce(py_algo::execution::par, columns, 0L, std::plus<>(),
+                                                                    compare));
+        };
+        count(std::equal_to<>());
+        count(std::not_equal_to<>());
+        count(std::less<>());
+        count(std::less_equal<>());
+        count(std::greater<>());
+        count(std::greater_equal<>());
+    };
+    expect_counts(x, w);
+    expect_counts(a, b);
+
+    std::list<int> l = {1, 2, 3, 4};
+    std::vector<int> v = {4, 3, 2, 1, 0};
+    ASSERT_EQ(20, py_algo::zip_transform_reduce(py_algo::zip(l, v), 0, std::plus<>(), std::multiplies<>()));
+    ASSERT_EQ(2, py_algo::zip_transform_reduce(py_algo::execution::par, py_algo::zip(l, v), 0, std::plus<>(),
+                                               std::greater<>()));
+    ASSERT_EQ("4664", py_algo::zip_transform_reduce(py_algo::zip(l, v), std::string(), std::plus<>(), [](int p, int q) {
+        return std::to_string(p * q % 7);
+    }));
+}
+
+static_assert([] {
+    std::array<int, 3> a = {1, 2, 3};
+    std::array<int, 4> b = {4, 5, 6, 7};
+    return py_algo::zip_transform_reduce(py_algo::zip(a, b), 0, std::plus<>(), std::multiplies<>()) == 32;
+}());
+
+// Lookup tables built at compile time from xrange and zip
+
+constexpr std::array<std::uint32_t, 256> crc32_table() {
+    std::array<std::uint32_t, 256> table{};
+    py_algo::xrange<std::uint32_t> indices(256);
+    for (auto [entry, index]: py_algo::zip(table, indices)) {
+        std::uint32_t crc = index;
+        for (int bit = 0; bit < 8; ++bit)
+            crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        entry = crc;
+    }
+
+    return table;
+}
+
+constexpr std::array<std::uint8_t, 256> gamma_table() {
+    std::array<std::uint8_t, 256> table{};
+    auto levels = py_algo::xrange<double>(0, 1 + 0.5 / 255, 1.0 / 255);
+    for (auto [entry, level]: py_algo::zip(table, levels))
+        entry = static_cast<std::uint8_t>(level * level * 255 + 0.5);
+
+    return table;
+}
+
+constexpr auto crc32_lookup = crc32_table();
+constexpr auto gamma_lookup = gamma_table();
+
+static_assert(crc32_lookup[0] == 0 && crc32_lookup[1] == 0x77073096u && crc32_lookup[255] == 0x2D02EF8Du);
+static_assert(gamma_lookup[0] == 0 && gamma_lookup[128] == 64 && gamma_lookup[255] == 255);
+static_assert(py_algo::all_of(crc32_lookup.begin() + 1, crc32_lookup.end(), [](std::uint32_t a) { return a != 0; }));
+static_assert([] {
+    py_algo::xrange<int> levels(256);
+    auto pairs = py_algo::zip(gamma_lookup, levels);
+    return py_algo::all_of(pairs.begin(), pairs.end(), [](auto _pair) {
+        auto [corrected, level] = _pair;
+        return corrected <= level;
+    });
+}());
+static_assert(py_algo::is_sorted(gamma_lookup.begin(), gamma_lookup.end()));
+
+constexpr bool xrange_queries() {
+    py_algo::xrange<int> range(10);
+    range = py_algo::xrange<int>(-3, 30, 4);
+    auto part = range.slice(2, 5);
+    return range.size() == 9 && range.sum() == 117 && range.index_of(13) == 4 && !range.contains(14) &&
+           part[0] == 5 && part.end() - part.begin() == 3 && *py_algo::find_backward(range.begin(), range.end(), 9) == 9 &&
+           py_algo::xrange<double>(0, 0.1 * 3, 0.1).size() == 3 && py_algo::xrange<double>(0, 1, 0.25).index_of(0.75) == 3;
+}
+
+static_assert(xrange_queries());
+static_assert(std::is_trivially_copyable_v<py_algo::xrange<double>>);
+static_assert(std::is_copy_assignable_v<py_algo::xrange<int>>);
+
+TEST(ZipTestSuit, ConstexprTablesTest) {
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (char c: std::string_view("123456789"))
+        crc = crc32_lookup[(crc ^ static_cast<std::uint8_t>(c)) & 0xFFu] ^ (crc >> 8);
+    ASSERT_EQ(0xCBF43926u, crc ^ 0xFFFFFFFFu);
+
+    py_algo::xrange<int> range(3);
+    range = py_algo::xrange<int>(5, 8);
+    ASSERT_EQ((std::vector<int>{5, 6, 7}), range.to_vector());
+}
+
+TEST(ViewsTestSuit, PipelineTest) {
+    using namespace py_algo::views;
+    auto squares = py_algo::xrange<int>(0, 20)
+                   | filter([](int x) { return x % 2 == 0; })
+                   | transform([](int x) { return x * x; });
+    ASSERT_EQ((std::vector<int>{0, 4, 16, 36, 64, 100, 144, 196, 256, 324}),
+              std::vector<int>(squares.begin(), squares.end()));
+    ASSERT_TRUE(py_algo::all_of(squares.begin(), squares.end(), [](int x) { return x % 4 == 0; }));
+    ASSERT_TRUE(py_algo::one_of(squares.begin(), squares.end(), [](int x) { return x == 36; }));
+
+    auto first_three = squares | take(3);
+    ASSERT_EQ((std::vector<int>{0, 4, 16}), std::vector<int>(first_three.begin(), first_three.end()));
+
+    std::vector<int> v = {5, 1, 4};
+    auto tripled = v | transform([](int x) { return 3 * x; }) | take(10);
+    ASSERT_EQ(3, tripled.end() - tripled.begin());
+    ASSERT_EQ(tripled.begin() + 1, py_algo::is_sorted_until(tripled.begin(), tripled.end()));
+
+    for (auto [index, value]: v | enumerate)
+        value += static_cast<int>(index);
+    ASSERT_EQ((std::vector<int>{5, 2, 6}), v);
+
+    std::list<int> l = {1, 2, 3, 4, 5};
+    auto odd = l | filter([](int x) { return x % 2 == 1; }) | take(2);
+    ASSERT_EQ((std::vector<int>{1, 3}), std::vector<int>(odd.begin(), odd.end()));
+
+    for (std::ptrdiff_t count: {std::ptrdiff_t(0), std::ptrdiff_t(-1), PTRDIFF_MIN}) {
+        auto none = v | take(count);
+        ASSERT_EQ(none.begin(), none.end());
+        auto none_listed = l | take(count);
+        ASSERT_EQ(none_listed.begin(), none_listed.end());
+    }
+}
+
+TEST(ViewsTestSuit, ZipPipelineTest) {
+    using namespace py_algo::views;
+    std::vector<int> keys = {3, 1, 4, 1, 5};
+    std::vector<std::string> names = {"c", "a", "d", "a'", "e"};
+    auto small = py_algo::zip(keys, names) | filter([](const auto& _row) { return std::get<0>(_row) < 4; });
+    std::vector<std::string> small_names;
+    for (auto [key, name]: small)
+        small_names.push_back(name);
+    ASSERT_EQ((std::vector<std::string>{"c", "a", "a'"}), small_names);
+
+    auto doubled = py_algo::xrange<int>(0, 5) | transform([](int x) { return 2 * x; });
+    std::size_t rows = 0;
+    for (auto [key, twice]: py_algo::zip(keys, doubled))
+        rows += key + twice;
+    ASSERT_EQ(34u, rows);
+}
+
+TEST(ViewsTestSuit, EnumerateTest) {
+    std::vector<std::string> words = {"one", "two", "three"};
+    std::size_t expected = 0;
+    for (auto [index, word]: py_algo::enumerate(words)) {
+        ASSERT_EQ(expected++, index);
+        ASSERT_EQ(&words[index], &word);
+        word += "!";
+    }
+    ASSERT_EQ(3, expected);
+    ASSERT_EQ("three!", words.back());
+
+    std::list<int> l = {7, 8, 9};
+    std::vector<std::pair<std::size_t, int>> pairs;
+    for (auto [index, x]: py_algo::enumerate(l, 1))
+        pairs.emplace_back(index, x);
+    ASSERT_EQ((std::vector<std::pair<std::size_t, int>>{{1, 7}, {2, 8}, {3, 9}}), pairs);
+
+    auto squares = py_algo::enumerate(py_algo::xrange<int>(5, 10));
+    ASSERT_EQ(5, squares.end() - squares.begin());
+    ASSERT_EQ(3u, std::get<0>(squares.begin()[3]));
+    ASSERT_EQ(8, std::get<1>(squares.begin()[3]));
+    auto large = std::find_if(squares.begin(), squares.end(), [](const auto& _pair) { return _pair.second > 7; });
+    ASSERT_EQ(3u, large.index());
+}
+
+TEST(RangesTestSuit, SentinelTest) {
+    static_assert(std::ranges::borrowed_range<py_algo::xrange<int>> && std::ranges::view<py_algo::xrange<int>>);
+    static_assert(std::ranges::view<py_algo::zip<std::vector<int>, std::list<int>>>);
+
+    auto range = py_algo::xrange<int>(10, 0, -3);
+    ASSERT_EQ(4, range.end_sentinel() - range.begin());
+    std::vector<int> values;
+    for (auto iter = range.begin(); iter != range.end_sentinel(); ++iter)
+        values.push_back(*iter);
+    ASSERT_EQ((std::vector<int>{10, 7, 4, 1}), values);
+    ASSERT_EQ(2u, range.slice(1, 3).end_sentinel() - range.slice(1, 3).begin());
+
+    std::vector<int> keys = {1, 2, 3, 4};
+    std::vector<char> letters = {'a', 'b', 'c'};
+    py_algo::zip short_zip(keys, letters);
+    ASSERT_EQ(3, short_zip.end_sentinel() - short_zip.begin());
+    ASSERT_EQ(short_zip.begin() + 3, short_zip.end());
+    auto rows = std::ranges::subrange(short_zip.begin(), short_zip.end_sentinel());
+    ASSERT_EQ(3u, rows.size());
+
+    std::list<int> list = {5, 6};
+    py_algo::zip list_zip(keys, list);
+    std::size_t steps = 0;
+    for (auto iter = list_zip.begin(); iter != list_zip.end_sentinel(); ++iter)
+        ++steps;
+    ASSERT_EQ(2u, steps);
+}
+
+TEST(RangesTestSuit, RangeOverloadsTest) {
+    std::vector<int> v = {1, 2, 3, 4, 5, 4, 3};
+    ASSERT_TRUE(py_algo::all_of(v, [](int a) { return a > 0; }));
+    ASSERT_TRUE(py_algo::any_of(v, [](int a) { return a == 5; }));
+    ASSERT_TRUE(py_algo::none_of(v, [](int a) { return a > 5; }));
+    ASSERT_TRUE(py_algo::one_of(v, [](int a) { return a == 5; }));
+    ASSERT_EQ(v.begin() + 5, py_algo::is_sorted_until(v));
+    ASSERT_FALSE(py_algo::is_sorted(v));
+    ASSERT_TRUE(py_algo::is_sorted(v, std::greater<>()) == false);
+    ASSERT_EQ(3u, py_algo::sortedness(v).runs);
+    ASSERT_EQ(v.begin() + 1, py_algo::find_not(v, 1));
+    ASSERT_EQ(v.begin() + 6, py_algo::find_backward(v, 3));
+    ASSERT_EQ(v.begin() + 2, py_algo::find_not_any_of(v, {1, 2}));
+    ASSERT_EQ(v.begin() + 6, py_algo::find_backward_any_of(v, std::vector<int>{2, 3}));
+    ASSERT_TRUE(py_algo::is_partitioned(v, [](int a) { return a < 3; }));
+    ASSERT_EQ(v.begin() + 2, py_algo::is_partitioned_at(v, [](int a) { return a < 3; }).partition_point);
+    ASSERT_EQ(1u, py_algo::quantify(v, [](int a) { return a == 5; }).count);
+
+    // Literals and strings still go to the std::string_view overload
+    ASSERT_TRUE(py_algo::is_palindrome("abba"));
+    ASSERT_TRUE(py_algo::is_palindrome(std::string("abcba")));
+    std::vector<int> mirrored = {1, 2, 1};
+    ASSERT_TRUE(py_algo::is_palindrome(mirrored));
+    ASSERT_TRUE(py_algo::is_palindrome(std::span<int>(mirrored)));
+
+    // Iterators into a temporary xrange stay valid, those into a temporary vector do not
+    auto found = py_algo::find_not(py_algo::xrange<int>(0, 10), 0);
+    ASSERT_EQ(1, *found);
+    static_assert(std::is_same_v<std::ranges::dangling, decltype(py_algo::find_not(std::vector<int>{1}, 1))>);
+
+    std::vector<int> keys = {1, 2, 3};
+    std::vector<std::string> names = {"a", "b", "c"};
+    ASSERT_TRUE(py_algo::all_of(py_algo::zip(keys, names), [](const auto& _row) {
+        return std::get<1>(_row).size() == 1;
+    }));
+    ASSERT_TRUE(py_algo::is_sorted(py_algo::xrange<int>(0, 30, 3)));
+}
+
+TEST(RangesTestSuit, StdViewsTest) {
+    // Views of xrange and zip copy them instead of referencing them
+    auto evens = py_algo::xrange<int>(0, 20) | std::views::filter([](int x) { return x % 2 == 0; })
+                 | std::views::take(4);
+    ASSERT_TRUE(py_algo::is_sorted(evens));
+    ASSERT_TRUE(py_algo::all_of(evens, [](int x) { return x < 8; }));
+
+    std::vector<int> keys = {3, 1, 2};
+    std::vector<char> letters = {'c', 'a', 'b'};
+    auto head = py_algo::zip(keys, letters) | std::views::take(2);
+    ASSERT_TRUE(py_algo::one_of(head, [](const auto& _row) { return std::get<1>(_row) == 'a'; }));
+
+    // iota iterators only have a C++20 iterator_concept, and take_while ends in a sentinel
+    auto numbers = std::views::iota(0, 10);
+    ASSERT_TRUE(py_algo::is_sorted(numbers));
+    ASSERT_EQ(7, *py_algo::find_backward(numbers, 7));
+    ASSERT_TRUE(py_algo::is_palindrome(std::views::iota(0, 1)));
+    ASSERT_FALSE(py_algo::is_palindrome(numbers));
+
+    std::vector<int> v = {1, 1, 2, 5, 3, 9, 0};
+    auto small = v | std::views::take_while([](int x) { return x < 9; });
+    static_assert(!std::ranges::common_range<decltype(small)>);
+    ASSERT_TRUE(py_algo::all_of(small, [](int x) { return x < 9; }));
+    ASSERT_EQ(v.begin() + 4, py_algo::is_sorted_until(small));
+    ASSERT_EQ(2u, py_algo::sortedness(small).runs);
+    ASSERT_EQ(v.begin() + 2, py_algo::find_not(small, 1));
+    ASSERT_EQ(v.begin() + 5, py_algo::find_not(small.begin(), small.end(), 1) + 3);
+    ASSERT_EQ(v.begin() + 1, py_algo::find_backward(small, 1));
+    ASSERT_EQ(v.begin() + 2, py_algo::is_partitioned_at(small, [](int x) { return x == 1; }).partition_point);
+    ASSERT_FALSE(py_algo::is_partitioned(small, [](int x) { return x > 2; }));
+
+    auto stats = py_algo::quantify(small, [](int x) { return x > 7; }, py_algo::quantifier::any_of);
+    ASSERT_EQ(0u, stats.count);
+    ASSERT_EQ(v.begin() + 5, stats.first_match);
+
+    // A sized sentinel lets random access pairs reach the iterator-pair kernels
+    auto counted = std::ranges::subrange(std::counted_iterator(v.begin(), 5), std::default_sentinel);
+    ASSERT_EQ(v.begin() + 4, py_algo::is_sorted_until(counted).base());
+    ASSERT_EQ(v.begin() + 2, py_algo::find_not(counted.begin(), counted.end(), 1).base());
+}
+
+// File in the temp directory with a random suffix, so concurrent runs do not share it, that is
+// removed when the test ends, failed assertions included
+struct temp_column {
+    std::string path;
+
+    explicit temp_column(const std::string& _name)
+        : path((std::filesystem::temp_directory_path() /
+                (_name + "." + std::to_string(std::random_device()()) + ".bin")).string()) {}
+
+    temp_column(const temp_column&) = delete;
+    temp_column& operator=(const temp_column&) = delete;
+
+    ~temp_column() {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+};
+
+template<typename T>
+void write_column(const temp_column& _file, const std::vector<T>& _values) {
+    std::ofstream file(_file.path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(_values.data()), static_cast<std::streamsize>(_values.size() * sizeof(T)));
+}
+
+TEST(RunIndexTestSuit, QueryTest) {
+    std::vector<int> v(1000, 0);
+    std::fill(v.begin() + 100, v.begin() + 110, 7);
+    v[500] = 3;
+    v[501] = 7;
+    py_algo::run_index index(v.begin(), v.end());
+    ASSERT_EQ(6, index.runs());
+    ASSERT_FALSE(index.saturated());
+    ASSERT_EQ(v.begin() + 100, py_algo::find_not(index, v.begin(), v.end(), 0));
+    ASSERT_EQ(v.begin() + 105, py_algo::find_not(index, v.begin() + 105, v.end(), 0));
+    ASSERT_EQ(v.begin() + 110, py_algo::find_not(index, v.begin() + 105, v.end(), 7));
+    ASSERT_EQ(v.begin() + 300, py_algo::find_not(index, v.begin() + 120, v.begin() + 300, 0));
+    ASSERT_EQ(v.begin() + 501, py_algo::find_backward(index, v.begin(), v.end(), 7));
+    ASSERT_EQ(v.begin() + 109, py_algo::find_backward(index, v.begin(), v.begin() + 500, 7));
+    ASSERT_EQ(v.begin() + 500, py_algo::find_backward(index, v.begin() + 110, v.begin() + 500, 7));
+    ASSERT_EQ(v.end(), py_algo::find_backward(index, v.begin(), v.end(), 5));
+    ASSERT_EQ(v.begin() + 3, py_algo::find_backward(index, v.begin() + 3, v.begin() + 3, 0));
+
+    // Point writes split and merge runs
+    v[104] = 0;
+    index.update(v.begin() + 104);
+    ASSERT_EQ(8, index.runs());
+    v[104] = 7;
+    index.update(v.begin() + 104);
+    v[500] = 7;
+    index.update(v.begin() + 500);
+    v[0] = 1;
+    index.update(v.begin());
+    v[999] = 1;
+    index.update(v.begin() + 999);
+    ASSERT_EQ(7, index.runs());
+    ASSERT_EQ(v.begin(), py_algo::find_not(index, v.begin(), v.end(), 0));
+    ASSERT_EQ(v.begin() + 502, py_algo::find_not(index, v.begin() + 500, v.end(), 7));
+    ASSERT_EQ(v.begin() + 999, py_algo::find_backward(index, v.begin(), v.end(), 1));
+    ASSERT_EQ(v.begin(), py_algo::find_backward(index, v.begin(), v.end() - 1, 1));
+}
+
+TEST(RunIndexTestSuit, RandomUpdatesTest) {
+    std::mt19937 engine(7);
+    std::vector<std::uint8_t> v(4096, 0);
+    py_algo::run_index index(v.begin(), v.end(), 4096);
+    for (int step = 0; step < 3000; ++step) {
+        auto pos = engine() % v.size();
+        v[pos] = static_cast<std::uint8_t>(engine() % 4 == 0 ? engine() % 3 : 0);
+        index.update(v.begin() + static_cast<std::ptrdiff_t>(pos));
+
+        auto a = static_cast<std::ptrdiff_t>(engine() % v.size());
+        auto b = static_cast<std::ptrdiff_t>(engine() % v.size());
+        auto first = v.begin() + std::min(a, b), last = v.begin() + std::max(a, b);
+        auto x = static_cast<std::uint8_t>(engine() % 3);
+        ASSERT_EQ(py_algo::find_not(first, last, x), py_algo::find_not(index, first, last, x));
+        ASSERT_EQ(py_algo::find_backward(first, last, x), py_algo::find_backward(index, first, last, x));
+    }
+    py_algo::run_index fresh(v.begin(), v.end(), 4096);
+    ASSERT_EQ(fresh.runs(), index.runs());
+}
+
+TEST(RunIndexTestSuit, SaturationTest) {
+    std::vector<int> v(1000);
+    std::iota(v.begin(), v.end(), 0);
+    py_algo::run_index index(v.begin(), v.end());
+    ASSERT_EQ(64, index.max_runs());
+    ASSERT_TRUE(index.saturated());
+    ASSERT_EQ(0, index.runs());
+    ASSERT_EQ(v.begin() + 1, py_algo::find_not(index, v.begin(), v.end(), 0));
+    ASSERT_EQ(v.begin() + 500, py_algo::find_backward(index, v.begin(), v.end(), 500));
+
+    std::fill(v.begin(), v.end(), 1);
+    index.rebuild();
+    ASSERT_FALSE(index.saturated());
+    ASSERT_EQ(1, index.runs());
+
+    py_algo::run_index bounded(v.begin(), v.end(), 100);
+    auto small = bounded.memory_usage();
+    ASSERT_GT(small, 0);
+    for (int i = 0; i < 40; ++i) {
+        v[i * 20] = 2;
+        bounded.update(v.begin() + i * 20);
+    }
+    ASSERT_EQ(80, bounded.runs());
+    ASSERT_GT(bounded.memory_usage(), small);
+    v[999] = 3;
+    bounded.update(v.end() - 1);
+    for (int i = 40; i < 50; ++i) {
+        ASSERT_FALSE(bounded.saturated());
+        v[i * 20] = 2;
+        bounded.update(v.begin() + i * 20);
+    }
+    ASSERT_TRUE(bounded.saturated());
+    ASSERT_EQ(0, bounded.memory_usage());
+    ASSERT_EQ(v.end() - 1, py_algo::find_not(bounded, v.begin() + 981, v.end(), 1));
+}
+
+TEST(MmapTestSuit, MmapRangeTest) {
+    std::vector<std::int32_t> ids(100000, 7);
+    ids[99998] = 8;
+    std::vector<double> prices(100000);
+    std::iota(prices.begin(), prices.end(), 0.0);
+    temp_column ids_file("py_algo_ids"), prices_file("py_algo_prices");
+    write_column(ids_file, ids);
+    write_column(prices_file, prices);
+
+    py_algo::mmap_range<std::int32_t> mapped_ids(ids_file.path);
+    const py_algo::mmap_range<double> mapped_prices(prices_file.path, py_algo::mmap_advice::willneed);
+    ASSERT_EQ(ids.size(), mapped_ids.size());
+    ASSERT_EQ(mapped_ids.begin() + 99998, py_algo::find_not(mapped_ids.begin(), mapped_ids.end(), 7));
+    ASSERT_TRUE(py_algo::is_sorted(py_algo::execution::par, mapped_prices.begin(), mapped_prices.end()));
+    ASSERT_FALSE(py_algo::all_of(mapped_ids.begin(), mapped_ids.end(), [](std::int32_t a) { return a == 7; }));
+
+    double total = 0;
+    for (auto [id, price]: py_algo::zip(mapped_ids, mapped_prices))
+        total += id == 8 ? price : 0.0;
+    ASSERT_DOUBLE_EQ(99998.0, total);
+
+    auto moved = std::move(mapped_ids);
+    ASSERT_TRUE(mapped_ids.empty());
+    ASSERT_EQ(8, moved[99998]);
+
+    temp_column empty_file("py_algo_empty");
+    write_column(empty_file, std::vector<std::int32_t>());
+    py_algo::mmap_range<std::int32_t> empty(empty_file.path);
+    ASSERT_TRUE(empty.empty());
+    ASSERT_EQ(empty.end(), py_algo::find_not(empty.begin(), empty.end(), 0));
+
+    temp_column odd_file("py_algo_odd");
+    write_column(odd_file, std::vector<char>(7));
+    ASSERT_THROW(py_algo::mmap_range<double>{odd_file.path}, std::invalid_argument);
+    ASSERT_THROW(py_algo::mmap_range<int>("/nonexistent/py_algo.bin"), std::system_error);
+}